@@ -0,0 +1,143 @@
+#include "Harness.hpp"
+
+#include <base/Trace.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+namespace vke::bench{
+    namespace{
+        uint32_t parseCount(std::string_view argument, std::string_view value)
+        {
+            uint32_t count = 0;
+            auto [ptr, error] = std::from_chars(value.data(), value.data() + value.size(), count);
+            if(error != std::errc{} || ptr != value.data() + value.size())
+                throw std::runtime_error{std::format("vulkan-execution-bench, Invalid value for {}: {}", argument, value)};
+            return count;
+        }
+
+        double getPercentile(std::span<const double> sorted, double percentile)
+        {
+            size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+            return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+        }
+    }
+
+    Options Options::parse(std::span<char*> arguments)
+    {
+        Options options{};
+
+        for(size_t index = 1; index < arguments.size(); index++)
+        {
+            std::string_view argument = arguments[index];
+            auto next = [&]() -> std::string_view
+            {
+                if(index + 1 >= arguments.size())
+                    throw std::runtime_error{std::format("vulkan-execution-bench, Missing value for {}", argument)};
+                return arguments[++index];
+            };
+
+            if(argument == "--warmup")
+                options.warmupIterations = parseCount(argument, next());
+            else if(argument == "--iterations")
+                options.iterations = std::max(parseCount(argument, next()), 1u);
+            else if(argument == "--filter")
+                options.filter = next();
+            else if(argument == "--device")
+                options.device = next();
+            else if(argument == "--output")
+                options.output = next();
+            else if(argument == "--list")
+                options.list = true;
+            else
+                throw std::runtime_error{std::format("vulkan-execution-bench, Unknown argument: {}\n"
+                    "usage: vulkan-execution-bench [--warmup N] [--iterations N] [--filter TEXT] [--device TEXT] [--output FILE] [--list]", argument)};
+        }
+
+        return options;
+    }
+
+    Harness::Harness(const Options& options)
+        : options{options} {}
+
+    void Harness::setContext(std::string key, std::string value)
+    {
+        context.emplace_back(std::move(key), std::move(value));
+    }
+
+    void Harness::run(const Benchmark& benchmark)
+    {
+        if(!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos)
+            return;
+
+        if(options.list)
+        {
+            std::cout << benchmark.name << '\n';
+            return;
+        }
+
+        uint32_t iterations = benchmark.maxIterations ? std::min(options.iterations, benchmark.maxIterations) : options.iterations;
+        uint32_t warmupIterations = benchmark.maxIterations ? std::min(options.warmupIterations, benchmark.maxIterations) : options.warmupIterations;
+
+        for(uint32_t iteration = 0; iteration < warmupIterations; iteration++)
+        {
+            benchmark.body();
+        }
+
+        std::vector<double> samples(iterations);
+        for(double& sample : samples)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            benchmark.body();
+            sample = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        }
+        std::ranges::sort(samples);
+
+        double mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        double variance = std::accumulate(samples.begin(), samples.end(), 0.0, 
+            [mean](double sum, double sample){ return sum + (sample - mean) * (sample - mean); }) / samples.size();
+
+        Result& result = results.emplace_back(Result{
+            .name = benchmark.name,
+            .warmupIterations = warmupIterations,
+            .iterations = iterations,
+            .itemsPerIteration = benchmark.itemsPerIteration,
+            .bytesPerIteration = benchmark.bytesPerIteration,
+            .mean = mean,
+            .stddev = std::sqrt(variance),
+            .min = samples.front(),
+            .p50 = getPercentile(samples, 50.0),
+            .p95 = getPercentile(samples, 95.0),
+            .p99 = getPercentile(samples, 99.0),
+            .max = samples.back() });
+
+        std::cerr << std::format("{:<40} mean {:>12.0f} ns  p50 {:>12.0f} ns  p99 {:>12.0f} ns\n", result.name, result.mean, result.p50, result.p99);
+    }
+
+    void Harness::writeJson(std::ostream& stream) const
+    {
+        stream << "{\n  \"context\": {";
+        for(size_t index = 0; index < context.size(); index++)
+        {
+            stream << std::format("{}\n    \"{}\": \"{}\"", index ? "," : "", escapeJson(context[index].first), escapeJson(context[index].second));
+        }
+        stream << "\n  },\n  \"benchmarks\": [";
+
+        for(size_t index = 0; index < results.size(); index++)
+        {
+            const Result& result = results[index];
+            stream << std::format("{}\n    {{\"name\": \"{}\", \"warmup_iterations\": {}, \"iterations\": {}, "
+                "\"mean_ns\": {:.1f}, \"stddev_ns\": {:.1f}, \"min_ns\": {:.1f}, \"p50_ns\": {:.1f}, \"p95_ns\": {:.1f}, \"p99_ns\": {:.1f}, \"max_ns\": {:.1f}, "
+                "\"items_per_iteration\": {}, \"items_per_second\": {:.1f}, \"bytes_per_iteration\": {}, \"bytes_per_second\": {:.1f}}}",
+                index ? "," : "", escapeJson(result.name), result.warmupIterations, result.iterations,
+                result.mean, result.stddev, result.min, result.p50, result.p95, result.p99, result.max,
+                result.itemsPerIteration, result.getItemsPerSecond(), result.bytesPerIteration, result.getBytesPerSecond());
+        }
+        stream << "\n  ]\n}\n";
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vke::bench{
+
+    struct Options
+    {
+        uint32_t warmupIterations = 5;
+        uint32_t iterations = 50;
+        std::string filter;
+        std::string device;
+        std::filesystem::path output;
+        bool list = false;
+
+        static Options parse(std::span<char*> arguments);
+    };
+
+    struct Benchmark
+    {
+        std::string name;
+        std::function<void()> body;
+        uint64_t itemsPerIteration = 1;
+        uint64_t bytesPerIteration = 0;
+        uint32_t maxIterations = 0;
+    };
+
+    struct Result
+    {
+        std::string name;
+        uint32_t warmupIterations = 0;
+        uint32_t iterations = 0;
+        uint64_t itemsPerIteration = 1;
+        uint64_t bytesPerIteration = 0;
+        double mean = 0.0;
+        double stddev = 0.0;
+        double min = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+
+        inline double getItemsPerSecond() const noexcept { return mean > 0.0 ? itemsPerIteration * 1e9 / mean : 0.0; }
+        inline double getBytesPerSecond() const noexcept { return mean > 0.0 ? bytesPerIteration * 1e9 / mean : 0.0; }
+    };
+
+    class Harness
+    {
+    public:
+        explicit Harness(const Options& options);
+
+        void setContext(std::string key, std::string value);
+        void run(const Benchmark& benchmark);
+
+        void writeJson(std::ostream& stream) const;
+        inline const std::vector<Result>& getResults() const noexcept { return results; }
+
+    private:
+        Options options;
+        std::vector<std::pair<std::string, std::string>> context;
+        std::vector<Result> results;
+    };
+
+}
@@ -0,0 +1,418 @@
+#include "Harness.hpp"
+
+#include <vulkan_execution.hpp>
+#include <exec/ParallelRecorder.hpp>
+#include <exec/Startup.hpp>
+#include <vulkan/vulkan_format_traits.hpp>
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <thread>
+
+namespace{
+    constexpr uint32_t family_index = 0;
+
+    vke::Device::CreateInfo createDeviceInfo(const std::string& deviceFilter)
+    {
+        return vke::Device::CreateInfo{
+            .physicalDevicSelecter{[](const vke::PhysicalDeviceCapabilities& p) -> uint32_t
+            {
+                switch(p.properties.deviceType)
+                {
+                case vk::PhysicalDeviceType::eDiscreteGpu: return 50;
+                case vk::PhysicalDeviceType::eIntegratedGpu: return 20;
+                case vk::PhysicalDeviceType::eVirtualGpu: return 10;
+                case vk::PhysicalDeviceType::eCpu: return 5;
+                default: return 0;
+                }
+            }, [deviceFilter](const vke::PhysicalDeviceCapabilities& p) -> bool
+            {
+                std::string_view deviceName = p.properties.deviceName.data();
+                return (deviceFilter.empty() || deviceName.find(deviceFilter) != std::string_view::npos) && 
+                    (p.queueFamilies.front().queueFlags & vk::QueueFlagBits::eGraphics);
+            } } };
+    }
+
+    void submitAndWait(const vke::Device& device, const vke::DeviceQueue& queue, const vk::raii::CommandBuffer& commandBuffer, const vk::raii::Fence& fence)
+    {
+        vk::CommandBuffer submitCommandBuffer = *commandBuffer;
+        queue.submit(vk::SubmitInfo{}.setCommandBuffers(submitCommandBuffer), *fence);
+
+        vk::Result result = static_cast<const vk::raii::Device&>(device).waitForFences(*fence, vk::True, UINT64_MAX);
+        vk::detail::resultCheck(result, "vulkan-execution-bench::submitAndWait");
+        static_cast<const vk::raii::Device&>(device).resetFences(*fence);
+    }
+
+    constexpr uint32_t startup_texture_count = 4;
+    constexpr uint32_t startup_texture_extent = 1024;
+
+    struct StartupState
+    {
+        std::optional<vke::Instance> instance;
+        std::optional<vke::Device> device;
+        std::optional<vke::NewDeleteDeviceMemoryResource> memoryResource;
+        std::optional<vke::MappedDeviceMemoryResource> mappedMemory;
+        std::optional<vke::VirtualSwapchain> swapchain;
+        std::vector<std::vector<std::byte>> pixels = std::vector<std::vector<std::byte>>(startup_texture_count);
+        std::vector<std::optional<vke::Buffer<std::byte>>> textures = std::vector<std::optional<vke::Buffer<std::byte>>>(startup_texture_count);
+    };
+
+    std::vector<std::byte> decodeTexture(uint32_t seed, uint32_t extent)
+    {
+        std::vector<std::byte> pixels(static_cast<size_t>(extent) * extent * 4);
+        uint32_t state = seed * 747796405u + 2891336453u;
+        for(size_t index = 0; index < pixels.size(); index++)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            pixels[index] = static_cast<std::byte>((state >> 24) ^ (index & 0xff));
+        }
+        return pixels;
+    }
+
+    void createStartupDevice(StartupState& state, const std::string& deviceFilter)
+    {
+        state.device.emplace(*state.instance, createDeviceInfo(deviceFilter));
+        state.memoryResource.emplace(*state.device);
+        state.mappedMemory.emplace(state.device->getPhysicalDevice(), &*state.memoryResource);
+    }
+
+    void createStartupSwapchain(StartupState& state)
+    {
+        state.swapchain.emplace(*state.device, vke::VirtualSwapchain::CreateInfo{
+            .imageExtent = vk::Extent2D{ 1280, 720 },
+            .imageUsage = vk::ImageUsageFlags{vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferDst},
+            .queueFamilyIndex = family_index }, vke::DeviceMemoryAllocator<>{*state.memoryResource});
+    }
+
+    void uploadStartupTexture(StartupState& state, uint32_t index)
+    {
+        state.textures[index].emplace(*state.device, vke::Buffer<std::byte>::CreateInfo{
+            .data = state.pixels[index],
+            .usage = vk::BufferUsageFlags{vk::BufferUsageFlagBits::eTransferSrc} }, vke::DeviceMemoryAllocator<std::byte>{*state.mappedMemory});
+    }
+
+    void renderFirstFrame(StartupState& state)
+    {
+        const vke::DeviceQueue& queue = state.device->getDeviceQueues(family_index).front();
+        vke::CommandPoolManager commandPoolManager{*state.device, vke::CommandPoolManager::CreateInfo{ .framesInFlight = state.swapchain->getImageCount() }};
+
+        uint32_t imageIndex = state.swapchain->acquireNextImage(queue).second;
+        commandPoolManager.beginFrame(imageIndex);
+
+        vk::Image image = state.swapchain->getImage(imageIndex);
+        vk::ImageSubresourceRange range{ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 };
+
+        const vk::raii::CommandBuffer& commandBuffer = commandPoolManager.allocate(family_index);
+        commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, 
+            vk::ImageMemoryBarrier{ {}, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, 
+                VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, range });
+        commandBuffer.clearColorImage(image, vk::ImageLayout::eTransferDstOptimal, vk::ClearColorValue{ std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 1.0f } }, range);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, 
+            vk::ImageMemoryBarrier{ vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead, vk::ImageLayout::eTransferDstOptimal, 
+                vk::ImageLayout::eTransferSrcOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, range });
+        commandBuffer.end();
+
+        vk::CommandBuffer submitCommandBuffer = *commandBuffer;
+        queue.submit(vk::SubmitInfo{}.setCommandBuffers(submitCommandBuffer));
+        state.swapchain->present(queue, imageIndex);
+        state.swapchain->flush();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        vke::bench::Options options = vke::bench::Options::parse(std::span<char*>{argv, static_cast<size_t>(argc)});
+        vke::bench::Harness harness{options};
+
+        harness.run({ .name = "instance/create", .body = []
+        {
+            vke::Instance instance{vke::Instance::CreateInfo{ .applicationName = "vulkan-execution-bench" }};
+        }, .maxIterations = 20 });
+
+        vke::Instance instance{vke::Instance::CreateInfo{ .applicationName = "vulkan-execution-bench" }};
+
+        harness.run({ .name = "device/create-uncached", .body = [&]
+        {
+            vke::clearPhysicalDeviceCapabilities();
+            vke::Device device{instance, createDeviceInfo(options.device)};
+        }, .maxIterations = 20 });
+
+        harness.run({ .name = "device/create", .body = [&]
+        {
+            vke::Device device{instance, createDeviceInfo(options.device)};
+        }, .maxIterations = 20 });
+
+        vke::Device device{instance, createDeviceInfo(options.device)};
+        const vk::raii::Device& nativeDevice = device;
+        const vk::raii::PhysicalDevice& physicalDevice = device.getPhysicalDevice();
+        const vke::DeviceQueue& queue = device.getDeviceQueues(family_index).front();
+
+        auto properties = physicalDevice.getProperties();
+        harness.setContext("device", std::string{properties.deviceName.data()});
+        harness.setContext("device_type", vk::to_string(properties.deviceType));
+        harness.setContext("api_version", std::format("{}.{}.{}", VK_API_VERSION_MAJOR(properties.apiVersion), 
+            VK_API_VERSION_MINOR(properties.apiVersion), VK_API_VERSION_PATCH(properties.apiVersion)));
+        harness.setContext("driver_version", std::to_string(properties.driverVersion));
+        harness.setContext("hardware_concurrency", std::to_string(std::thread::hardware_concurrency()));
+
+        vke::NewDeleteDeviceMemoryResource memoryResource{device};
+        vke::MappedDeviceMemoryResource mappedMemory{physicalDevice, &memoryResource};
+        vke::FilterDeviceMemoryResource deviceLocalMemory{physicalDevice, &memoryResource, vk::MemoryPropertyFlagBits::eDeviceLocal};
+        vke::FilterDeviceMemoryResource coherentMemory{physicalDevice, &memoryResource, 
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent};
+        vke::MappedDeviceMemoryResource mappedCoherentMemory{physicalDevice, &coherentMemory};
+        vke::setDefaultDeviceMemoryResource(&mappedMemory);
+
+        vk::MemoryRequirements requirements{ 1 << 20, 256, ~0u };
+
+        harness.run({ .name = "memory/new-delete", .body = [&]
+        {
+            memoryResource.deallocate(memoryResource.allocate(requirements));
+        } });
+
+        harness.run({ .name = "memory/mapped", .body = [&]
+        {
+            mappedMemory.deallocate(mappedMemory.allocate(requirements));
+        } });
+
+        harness.run({ .name = "memory/mapped-filter-chain", .body = [&]
+        {
+            mappedCoherentMemory.deallocate(mappedCoherentMemory.allocate(requirements));
+        } });
+
+        harness.run({ .name = "buffer/create", .body = [&]
+        {
+            vke::Buffer<std::byte> buffer{device, vke::BufferWrapper::CreateInfo{ 
+                .size = 64 << 10, 
+                .usage = vk::BufferUsageFlags{vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst} }, 
+                vke::DeviceMemoryAllocator<std::byte>{deviceLocalMemory}};
+        } });
+
+        harness.run({ .name = "image/create", .body = [&]
+        {
+            vke::Image image{device, vke::Image::CreateInfo{
+                .usage = vk::ImageUsageFlags{vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst},
+                .formatFeatureFlags = vk::FormatFeatureFlags{vk::FormatFeatureFlagBits::eSampledImage},
+                .formatSelecter{ nullptr, std::vector{vk::Format::eR8G8B8A8Unorm} },
+                .extent = vk::Extent3D{ 512, 512, 1 } }, vke::DeviceMemoryAllocator<>{deviceLocalMemory}};
+        } });
+
+        harness.run({ .name = "format/select-scored", .body = [&]
+        {
+            vke::Image image{device, vke::Image::CreateInfo{
+                .usage = vk::ImageUsageFlags{vk::ImageUsageFlagBits::eDepthStencilAttachment},
+                .formatFeatureFlags = vk::FormatFeatureFlags{vk::FormatFeatureFlagBits::eDepthStencilAttachment},
+                .formatSelecter{ [](const vk::Format& format) -> uint32_t { return vk::componentBits(format, 0) + (vk::componentCount(format) > 1 ? 1 : 0); } },
+                .extent = vk::Extent3D{ 64, 64, 1 } }, vke::DeviceMemoryAllocator<>{deviceLocalMemory}};
+        } });
+
+        vk::raii::CommandPool commandPool{ nativeDevice, vk::CommandPoolCreateInfo{ vk::CommandPoolCreateFlagBits::eResetCommandBuffer, family_index } };
+        vk::raii::CommandBuffer commandBuffer = std::move(vk::raii::CommandBuffers{ nativeDevice, 
+            vk::CommandBufferAllocateInfo{ *commandPool, vk::CommandBufferLevel::ePrimary, 1 } }.front());
+        vk::raii::Fence fence{ nativeDevice, vk::FenceCreateInfo{} };
+
+        {
+            constexpr vk::DeviceSize upload_size = 16 << 20;
+
+            vke::Buffer<std::byte> staging{device, vke::BufferWrapper::CreateInfo{ 
+                .size = upload_size, .usage = vk::BufferUsageFlags{vk::BufferUsageFlagBits::eTransferSrc} }, 
+                vke::DeviceMemoryAllocator<std::byte>{mappedMemory}};
+            vke::Buffer<std::byte> target{device, vke::BufferWrapper::CreateInfo{ 
+                .size = upload_size, .usage = vk::BufferUsageFlags{vk::BufferUsageFlagBits::eTransferDst} }, 
+                vke::DeviceMemoryAllocator<std::byte>{deviceLocalMemory}};
+            std::vector<std::byte> source(upload_size, std::byte{0x5a});
+
+            harness.run({ .name = "upload/staging-copy", .body = [&]
+            {
+                std::memcpy(staging.data(), source.data(), upload_size);
+
+                commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+                commandBuffer.copyBuffer(static_cast<vk::Buffer>(staging), static_cast<vk::Buffer>(target), vk::BufferCopy{ 0, 0, upload_size });
+                commandBuffer.end();
+
+                submitAndWait(device, queue, commandBuffer, fence);
+            }, .bytesPerIteration = upload_size });
+        }
+
+        {
+            constexpr uint32_t submit_count = 256;
+
+            harness.run({ .name = "submit/direct", .body = [&]
+            {
+                for(uint32_t index = 0; index < submit_count; index++)
+                {
+                    queue.submit(vk::SubmitInfo{});
+                }
+                queue.waitIdle();
+            }, .itemsPerIteration = submit_count });
+
+            if(device.getEnabledFeatures().synchronization2)
+            {
+                vke::SubmissionQueue submissionQueue{device, queue, vke::SubmissionQueue::CreateInfo{}};
+
+                harness.run({ .name = "submit/submission-queue", .body = [&]
+                {
+                    for(uint32_t index = 0; index < submit_count; index++)
+                    {
+                        submissionQueue.submit(vke::SubmissionQueue::Submission{});
+                    }
+                    submissionQueue.flush();
+                    queue.waitIdle();
+                }, .itemsPerIteration = submit_count });
+            }
+        }
+
+        {
+            constexpr uint32_t item_count = 4096;
+            constexpr vk::DeviceSize item_size = 16;
+
+            vke::Buffer<std::byte> target{device, vke::BufferWrapper::CreateInfo{ 
+                .size = item_count * item_size, .usage = vk::BufferUsageFlags{vk::BufferUsageFlagBits::eTransferDst} }, 
+                vke::DeviceMemoryAllocator<std::byte>{deviceLocalMemory}};
+            vk::Buffer targetBuffer = static_cast<vk::Buffer>(target);
+
+            for(uint32_t threadCount = 1; threadCount <= std::max(std::thread::hardware_concurrency(), 1u); threadCount *= 2)
+            {
+                vke::CommandPoolManager commandPoolManager{device, vke::CommandPoolManager::CreateInfo{}};
+                vke::ParallelRecorder recorder{commandPoolManager, vke::ParallelRecorder::CreateInfo{ .threadCount = threadCount }};
+                uint32_t frameIndex = 0;
+
+                harness.run({ .name = std::format("record/parallel-secondary/threads:{}", threadCount), .body = [&]
+                {
+                    commandPoolManager.beginFrame(frameIndex++ % commandPoolManager.getFramesInFlight());
+                    recorder.recordSecondary(vke::ParallelRecorder::RecordInfo{ .queueFamilyIndex = family_index, .itemCount = item_count }, 
+                        [&](const vk::raii::CommandBuffer& secondary, uint32_t firstItem, uint32_t itemCount)
+                        {
+                            for(uint32_t item = firstItem; item < firstItem + itemCount; item++)
+                            {
+                                secondary.fillBuffer(targetBuffer, item * item_size, item_size, item);
+                            }
+                        });
+                }, .itemsPerIteration = item_count });
+            }
+        }
+
+        {
+            constexpr uint32_t frame_count = 16;
+
+            vke::VirtualSwapchain swapchain{device, vke::VirtualSwapchain::CreateInfo{
+                .imageExtent = vk::Extent2D{ 1280, 720 },
+                .imageUsage = vk::ImageUsageFlags{vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferDst},
+                .queueFamilyIndex = family_index }, vke::DeviceMemoryAllocator<>{deviceLocalMemory}};
+            vke::CommandPoolManager commandPoolManager{device, vke::CommandPoolManager::CreateInfo{ .framesInFlight = swapchain.getImageCount() }};
+            vke::FrameStatistics statistics{vke::FrameStatistics::CreateInfo{}};
+
+            harness.run({ .name = "frame/headless-clear", .body = [&]
+            {
+                for(uint32_t frame = 0; frame < frame_count; frame++)
+                {
+                    statistics.beginFrame();
+
+                    uint32_t imageIndex = 0;
+                    {
+                        auto timer = statistics.measure(vke::FrameStatistics::Metric::eAcquireWait);
+                        imageIndex = swapchain.acquireNextImage(queue).second;
+                    }
+                    commandPoolManager.beginFrame(imageIndex);
+
+                    vk::Image image = swapchain.getImage(imageIndex);
+                    vk::ImageSubresourceRange range{ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 };
+
+                    const vk::raii::CommandBuffer& frameCommandBuffer = commandPoolManager.allocate(family_index);
+                    frameCommandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+                    frameCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, 
+                        vk::ImageMemoryBarrier{ {}, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, 
+                            VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, range });
+                    frameCommandBuffer.clearColorImage(image, vk::ImageLayout::eTransferDstOptimal, 
+                        vk::ClearColorValue{ std::array<float, 4>{ static_cast<float>(frame) / frame_count, 0.0f, 0.0f, 1.0f } }, range);
+                    frameCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, 
+                        vk::ImageMemoryBarrier{ vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead, vk::ImageLayout::eTransferDstOptimal, 
+                            vk::ImageLayout::eTransferSrcOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, range });
+                    frameCommandBuffer.end();
+
+                    vk::CommandBuffer submitCommandBuffer = *frameCommandBuffer;
+                    queue.submit(vk::SubmitInfo{}.setCommandBuffers(submitCommandBuffer));
+                    swapchain.present(queue, imageIndex);
+
+                    statistics.endFrame();
+                }
+                swapchain.flush();
+            }, .itemsPerIteration = frame_count });
+
+            auto cpuFrameTime = statistics.getPercentiles(vke::FrameStatistics::Metric::eCpuFrameTime);
+            harness.setContext("frame_cpu_p99_ns", std::to_string(cpuFrameTime.p99.count()));
+        }
+
+        harness.run({ .name = "startup/sequential", .body = [&]
+        {
+            StartupState state;
+            state.instance.emplace(vke::Instance::CreateInfo{ .applicationName = "vulkan-execution-bench" });
+            createStartupDevice(state, options.device);
+            for(uint32_t index = 0; index < startup_texture_count; index++)
+                state.pixels[index] = decodeTexture(index, startup_texture_extent);
+            for(uint32_t index = 0; index < startup_texture_count; index++)
+                uploadStartupTexture(state, index);
+            createStartupSwapchain(state);
+            renderFirstFrame(state);
+        }, .maxIterations = 10 });
+
+        harness.run({ .name = "startup/graph", .body = [&]
+        {
+            StartupState state;
+            vke::StartupGraph graph{vke::StartupGraph::CreateInfo{}};
+
+            auto instanceTask = graph.add("instance", {}, [&]
+            {
+                state.instance.emplace(vke::Instance::CreateInfo{ .applicationName = "vulkan-execution-bench" });
+            });
+            auto deviceTask = graph.add("device", {instanceTask}, [&]{ createStartupDevice(state, options.device); });
+            auto swapchainTask = graph.add("swapchain", {deviceTask}, [&]{ createStartupSwapchain(state); });
+
+            std::vector<vke::StartupGraph::TaskId> frameDependencies{swapchainTask};
+            for(uint32_t index = 0; index < startup_texture_count; index++)
+            {
+                auto decodeTask = graph.add(std::format("decode:{}", index), {}, [&state, index]
+                {
+                    state.pixels[index] = decodeTexture(index, startup_texture_extent);
+                });
+                frameDependencies.push_back(graph.add(std::format("upload:{}", index), {deviceTask, decodeTask}, [&state, index]
+                {
+                    uploadStartupTexture(state, index);
+                }));
+            }
+            graph.add("first-frame", frameDependencies, [&]{ renderFirstFrame(state); });
+
+            graph.wait();
+        }, .maxIterations = 10 });
+
+        if(options.list)
+            return 0;
+
+        if(options.output.empty())
+        {
+            harness.writeJson(std::cout);
+        }
+        else
+        {
+            std::ofstream stream{options.output, std::ios::trunc};
+            if(!stream)
+                throw std::runtime_error{std::format("vulkan-execution-bench, Failed to open {}", options.output.string())};
+            harness.writeJson(stream);
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+if(Vulkan_GLSLANG_VALIDATOR_EXECUTABLE)
+    set(VKE_GLSLANG_VALIDATOR "${Vulkan_GLSLANG_VALIDATOR_EXECUTABLE}" CACHE FILEPATH "glslang compiler used by vke_embed_shaders")
+else()
+    find_program(VKE_GLSLANG_VALIDATOR NAMES glslangValidator glslang HINTS "$ENV{VULKAN_SDK}/bin")
+endif()
+find_program(VKE_SPIRV_OPT NAMES spirv-opt HINTS "$ENV{VULKAN_SDK}/bin")
+
+# vke_embed_shaders(<target>
+#     SOURCES <glsl files...>
+#     [HEADER <file name>]                       default: <target>_shaders.hpp
+#     [NAMESPACE <namespace>]                    default: shaders
+#     [OPTIMIZE NONE | SIZE | PERFORMANCE]       default: PERFORMANCE
+#     [TARGET_ENV <glslang target env>]          default: vulkan1.2
+#     [KEEP_DEBUG_INFO])
+#
+# Compiles GLSL to SPIR-V, runs spirv-opt and generates a header with one
+# vke::ShaderModule::Embedded per shader. Debug info is stripped in Release and
+# MinSizeRel unless KEEP_DEBUG_INFO is set.
+function(vke_embed_shaders target)
+    cmake_parse_arguments(PARSE_ARGV 1 arg "KEEP_DEBUG_INFO" "HEADER;NAMESPACE;OPTIMIZE;TARGET_ENV" "SOURCES")
+
+    if(NOT arg_HEADER)
+        set(arg_HEADER "${target}_shaders.hpp")
+    endif()
+    if(NOT arg_NAMESPACE)
+        set(arg_NAMESPACE "shaders")
+    endif()
+    if(NOT arg_OPTIMIZE)
+        set(arg_OPTIMIZE "PERFORMANCE")
+    endif()
+    if(NOT arg_TARGET_ENV)
+        set(arg_TARGET_ENV "vulkan1.2")
+    endif()
+
+    if(NOT VKE_GLSLANG_VALIDATOR)
+        message(FATAL_ERROR "vke_embed_shaders, glslangValidator was not found")
+    endif()
+    if(NOT VKE_SPIRV_OPT)
+        message(FATAL_ERROR "vke_embed_shaders, spirv-opt was not found")
+    endif()
+
+    if(arg_OPTIMIZE STREQUAL "PERFORMANCE")
+        set(optimize_flags -O)
+    elseif(arg_OPTIMIZE STREQUAL "SIZE")
+        set(optimize_flags -Os)
+    elseif(arg_OPTIMIZE STREQUAL "NONE")
+        set(optimize_flags "")
+    else()
+        message(FATAL_ERROR "vke_embed_shaders, Unknown OPTIMIZE preset ${arg_OPTIMIZE}")
+    endif()
+
+    if(arg_KEEP_DEBUG_INFO)
+        set(strip_flags "")
+    else()
+        set(strip_flags "$<$<CONFIG:Release,MinSizeRel>:--strip-debug>")
+    endif()
+
+    set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/${target}_shaders")
+    set(header "${output_dir}/${arg_HEADER}")
+
+    foreach(glsl_file ${arg_SOURCES})
+        get_filename_component(glsl_path "${glsl_file}" ABSOLUTE)
+        file(RELATIVE_PATH rel_path "${CMAKE_CURRENT_SOURCE_DIR}" "${glsl_path}")
+        get_filename_component(shader_name "${glsl_path}" NAME)
+        string(MAKE_C_IDENTIFIER "${shader_name}" shader_name)
+
+        set(spv_file "${output_dir}/${rel_path}.spv")
+        set(opt_file "${output_dir}/${rel_path}.opt.spv")
+        get_filename_component(spv_dir "${spv_file}" DIRECTORY)
+
+        add_custom_command(
+            OUTPUT "${spv_file}"
+            COMMAND ${CMAKE_COMMAND} -E make_directory "${spv_dir}"
+            COMMAND "${VKE_GLSLANG_VALIDATOR}" -V --target-env ${arg_TARGET_ENV} "${glsl_path}" -o "${spv_file}"
+            DEPENDS "${glsl_path}"
+            COMMENT "Compiling ${rel_path}"
+            VERBATIM
+        )
+        add_custom_command(
+            OUTPUT "${opt_file}"
+            COMMAND "${VKE_SPIRV_OPT}" ${optimize_flags} ${strip_flags} "${spv_file}" -o "${opt_file}"
+            DEPENDS "${spv_file}"
+            COMMENT "Optimizing ${rel_path}"
+            COMMAND_EXPAND_LISTS
+            VERBATIM
+        )
+
+        list(APPEND opt_files "${opt_file}")
+        list(APPEND shader_arguments "${shader_name}=${opt_file}")
+    endforeach()
+
+    add_custom_command(
+        OUTPUT "${header}"
+        COMMAND vke-shader-embed --output "${header}" --namespace ${arg_NAMESPACE} ${shader_arguments}
+        DEPENDS vke-shader-embed ${opt_files}
+        COMMENT "Embedding shaders into ${arg_HEADER}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE "${header}")
+    target_include_directories(${target} PRIVATE "${output_dir}")
+endfunction()
@@ -1,8 +1,220 @@
 #include "Base.hpp"
+#include "Instrumentation.hpp"
 
+#include <format>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <mutex>
+#include <unordered_map>
 
 namespace vke{
+    namespace{
+        struct InstanceCapabilities
+        {
+            std::vector<vk::ExtensionProperties> extensions;
+            std::vector<vk::LayerProperties> layers;
+        };
+
+        const InstanceCapabilities& getInstanceCapabilities(const vk::raii::Context& context)
+        {
+            static std::once_flag flag;
+            static InstanceCapabilities capabilities{};
+            std::call_once(flag, [&]
+            {
+                capabilities.extensions = context.enumerateInstanceExtensionProperties();
+                capabilities.layers = context.enumerateInstanceLayerProperties();
+            });
+            return capabilities;
+        }
+
+        constexpr uint32_t capabilities_file_magic = 0x43454b56;
+        constexpr uint32_t capabilities_file_version = 1;
+
+        std::mutex capabilities_mutex;
+        std::unordered_map<std::string, PhysicalDeviceCapabilities> capabilities_cache;
+
+        std::string getCapabilitiesKey(const vk::PhysicalDeviceProperties& properties)
+        {
+            std::string key = std::format("{:08x}-{:08x}-{:08x}-{:08x}-", properties.vendorID, properties.deviceID, 
+                properties.driverVersion, properties.apiVersion);
+            for(uint8_t byte : properties.pipelineCacheUUID)
+            {
+                key += std::format("{:02x}", byte);
+            }
+            return key;
+        }
+
+        PhysicalDeviceCapabilities queryPhysicalDeviceCapabilities(const vk::raii::PhysicalDevice& physicalDevice, 
+            const vk::PhysicalDeviceProperties& properties)
+        {
+            PhysicalDeviceCapabilities capabilities{};
+            capabilities.properties = properties;
+            capabilities.extensions = physicalDevice.enumerateDeviceExtensionProperties();
+            capabilities.queueFamilies = physicalDevice.getQueueFamilyProperties();
+            capabilities.memoryProperties = physicalDevice.getMemoryProperties();
+
+            vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceTimelineSemaphoreFeatures,
+                vk::PhysicalDeviceSynchronization2Features, vk::PhysicalDevicePresentIdFeaturesKHR, vk::PhysicalDevicePresentWaitFeaturesKHR> features{};
+
+            if(properties.apiVersion < vk::ApiVersion12 && !capabilities.isExtensionSupported(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+                features.unlink<vk::PhysicalDeviceTimelineSemaphoreFeatures>();
+            if(properties.apiVersion < vk::ApiVersion13 && !capabilities.isExtensionSupported(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+                features.unlink<vk::PhysicalDeviceSynchronization2Features>();
+            if(!capabilities.isExtensionSupported(VK_KHR_PRESENT_ID_EXTENSION_NAME))
+                features.unlink<vk::PhysicalDevicePresentIdFeaturesKHR>();
+            if(!capabilities.isExtensionSupported(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+                features.unlink<vk::PhysicalDevicePresentWaitFeaturesKHR>();
+
+            physicalDevice.getDispatcher()->vkGetPhysicalDeviceFeatures2(static_cast<VkPhysicalDevice>(*physicalDevice), 
+                reinterpret_cast<VkPhysicalDeviceFeatures2*>(&features.get<vk::PhysicalDeviceFeatures2>()));
+            capabilities.features = features.get<vk::PhysicalDeviceFeatures2>().features;
+            capabilities.timelineSemaphore = features.get<vk::PhysicalDeviceTimelineSemaphoreFeatures>().timelineSemaphore;
+            capabilities.synchronization2 = features.get<vk::PhysicalDeviceSynchronization2Features>().synchronization2;
+            capabilities.presentId = features.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId;
+            capabilities.presentWait = features.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait;
+            return capabilities;
+        }
+
+        template<class T>
+        void writeRaw(std::ostream& stream, const T& value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<class T>
+        bool readRaw(std::istream& stream, T& value)
+        {
+            return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+
+        template<class T>
+        void writeArray(std::ostream& stream, const std::vector<T>& values)
+        {
+            writeRaw(stream, static_cast<uint32_t>(values.size()));
+            stream.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        }
+
+        template<class T>
+        bool readArray(std::istream& stream, std::vector<T>& values)
+        {
+            uint32_t count = 0;
+            if(!readRaw(stream, count) || count > (1u << 16))
+                return false;
+            values.resize(count);
+            return static_cast<bool>(stream.read(reinterpret_cast<char*>(values.data()), count * sizeof(T)));
+        }
+    }
+
+    bool PhysicalDeviceCapabilities::isExtensionSupported(std::string_view extensionName) const noexcept
+    {
+        return std::ranges::find(extensions, extensionName, 
+            [](const vk::ExtensionProperties& p) -> std::string_view { return p.extensionName.data(); }) != std::ranges::end(extensions);
+    }
+
+    std::vector<PhysicalDeviceCapabilities> getPhysicalDeviceCapabilities(std::span<const vk::raii::PhysicalDevice> physicalDevices)
+    {
+        std::vector<PhysicalDeviceCapabilities> capabilities(physicalDevices.size());
+        std::vector<std::future<PhysicalDeviceCapabilities>> queries(physicalDevices.size());
+
+        for(const auto& [index, physicalDevice] : physicalDevices | std::views::enumerate)
+        {
+            auto properties = physicalDevice.getProperties();
+            std::string key = getCapabilitiesKey(properties);
+            {
+                std::lock_guard lock{capabilities_mutex};
+                if(auto it = capabilities_cache.find(key); it != capabilities_cache.end())
+                {
+                    capabilities[index] = it->second;
+                    capabilities[index].physicalDevice = physicalDevice;
+                    continue;
+                }
+            }
+
+            queries[index] = std::async(physicalDevices.size() > 1 ? std::launch::async : std::launch::deferred, 
+                [&physicalDevice, properties]{ return queryPhysicalDeviceCapabilities(physicalDevice, properties); });
+        }
+
+        for(auto&& [index, query] : queries | std::views::enumerate)
+        {
+            if(!query.valid())
+                continue;
+
+            capabilities[index] = query.get();
+            {
+                std::lock_guard lock{capabilities_mutex};
+                capabilities_cache.insert_or_assign(getCapabilitiesKey(capabilities[index].properties), capabilities[index]);
+            }
+            capabilities[index].physicalDevice = physicalDevices[index];
+        }
+
+        return capabilities;
+    }
+
+    void loadPhysicalDeviceCapabilities(const std::filesystem::path& path)
+    {
+        std::ifstream stream{path, std::ios::binary};
+        if(!stream)
+            return;
+
+        uint32_t magic = 0, version = 0, headerVersion = 0, count = 0;
+        if(!readRaw(stream, magic) || !readRaw(stream, version) || !readRaw(stream, headerVersion) || !readRaw(stream, count) || 
+            magic != capabilities_file_magic || version != capabilities_file_version || headerVersion != VK_HEADER_VERSION)
+            return;
+
+        std::vector<PhysicalDeviceCapabilities> entries(count);
+        for(PhysicalDeviceCapabilities& entry : entries)
+        {
+            uint8_t flags = 0;
+            if(!readRaw(stream, entry.properties) || !readRaw(stream, entry.features) || !readRaw(stream, entry.memoryProperties) || 
+                !readRaw(stream, flags) || !readArray(stream, entry.extensions) || !readArray(stream, entry.queueFamilies))
+                return;
+
+            entry.timelineSemaphore = flags & 0x1;
+            entry.synchronization2 = flags & 0x2;
+            entry.presentId = flags & 0x4;
+            entry.presentWait = flags & 0x8;
+        }
+
+        std::lock_guard lock{capabilities_mutex};
+        for(PhysicalDeviceCapabilities& entry : entries)
+        {
+            std::string key = getCapabilitiesKey(entry.properties);
+            capabilities_cache.try_emplace(std::move(key), std::move(entry));
+        }
+    }
+
+    void savePhysicalDeviceCapabilities(const std::filesystem::path& path)
+    {
+        std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+        if(!stream)
+            throw std::runtime_error{std::format("vke::savePhysicalDeviceCapabilities, Failed to open {}", path.string())};
+
+        std::lock_guard lock{capabilities_mutex};
+        writeRaw(stream, capabilities_file_magic);
+        writeRaw(stream, capabilities_file_version);
+        writeRaw(stream, static_cast<uint32_t>(VK_HEADER_VERSION));
+        writeRaw(stream, static_cast<uint32_t>(capabilities_cache.size()));
+
+        for(const auto& [key, entry] : capabilities_cache)
+        {
+            uint8_t flags = (entry.timelineSemaphore ? 0x1 : 0) | (entry.synchronization2 ? 0x2 : 0) | 
+                (entry.presentId ? 0x4 : 0) | (entry.presentWait ? 0x8 : 0);
+
+            writeRaw(stream, entry.properties);
+            writeRaw(stream, entry.features);
+            writeRaw(stream, entry.memoryProperties);
+            writeRaw(stream, flags);
+            writeArray(stream, entry.extensions);
+            writeArray(stream, entry.queueFamilies);
+        }
+    }
+
+    void clearPhysicalDeviceCapabilities()
+    {
+        std::lock_guard lock{capabilities_mutex};
+        capabilities_cache.clear();
+    }
     
 	Instance::Instance(const CreateInfo& createInfo_)
 	{
@@ -12,20 +224,16 @@ namespace vke{
 			| vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning | vk::DebugUtilsMessageSeverityFlagBitsEXT::eError);
 		debugCreateInfo.setMessageType(vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral
 			| vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance | vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation);
-		debugCreateInfo.setPfnUserCallback(
-			[](vk::DebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
-				vk::DebugUtilsMessageTypeFlagsEXT messageType,
-				const vk::DebugUtilsMessengerCallbackDataEXT* pCallbackData,
-				void* pUserData)
-			{
-				std::cout << "validation layer: " << pCallbackData->pMessage << std::endl;
-
-				return VK_FALSE;
-			});
+		DebugMessageQueue::CreateInfo debugMessageQueueInfo = createInfo_.debugMessageQueue;
+		if(debugMessageQueueInfo.sinks.empty())
+			debugMessageQueueInfo.sinks.push_back(DebugMessageQueue::createStreamSink(std::cerr));
+		debugMessageQueue = std::make_unique<DebugMessageQueue>(debugMessageQueueInfo);
+
+		debugCreateInfo.setPfnUserCallback(&DebugMessageQueue::callback);
+		debugCreateInfo.setPUserData(debugMessageQueue.get());
 #endif
 		{
-			auto extensionProperties = context.enumerateInstanceExtensionProperties();
-			auto layerProperties = context.enumerateInstanceLayerProperties();
+			const auto& [extensionProperties, layerProperties] = getInstanceCapabilities(context);
 
 			std::vector<const char*> extensions = std::ranges::to<std::vector<const char*>>(extensionProperties
 				| std::ranges::views::filter(createInfo_.enabledExtensionChecker)
@@ -57,28 +265,139 @@ namespace vke{
 				.setPNext(&debugCreateInfo)
 #endif
 				};
+
+			enabledExtensions = std::ranges::to<std::vector<std::string>>(extensions);
 		}
 
+#ifdef _DEBUG
 		debugMessenger = vk::raii::DebugUtilsMessengerEXT{instance, debugCreateInfo};
+#endif
+	}
+
+	Instance& Instance::operator=(Instance&& other) noexcept
+	{
+		if(this == &other)
+			return *this;
+
+		// The messenger may still call into the old queue until it and its instance are gone.
+#ifdef _DEBUG
+		debugMessenger.clear();
+#endif
+		instance.clear();
+		debugMessageQueue = std::move(other.debugMessageQueue);
+
+		context = std::move(other.context);
+		instance = std::move(other.instance);
+		enabledExtensions = std::move(other.enabledExtensions);
+#ifdef _DEBUG
+		debugMessenger = std::move(other.debugMessenger);
+#endif
+		return *this;
+	}
+    
+	bool Instance::isExtensionEnabled(std::string_view extensionName) const noexcept
+	{
+		return std::ranges::find(enabledExtensions, extensionName) != std::ranges::end(enabledExtensions);
 	}
     
-    DeviceQueue::DeviceQueue(const vk::raii::Device& device_, uint32_t queueFamilyIndex_, uint32_t queueIndex_)
+    DeviceQueue::DeviceQueue(const vk::raii::Device& device_, uint32_t queueFamilyIndex_, uint32_t queueIndex_, bool timelineSemaphore)
         : queueFamilyIndex(queueFamilyIndex_), queueIndex(queueIndex_)
-        , queue{device_, queueFamilyIndex_, queueIndex_} {}
+        , queue{device_, queueFamilyIndex_, queueIndex_}
+    {
+        if(timelineSemaphore)
+            p_state->semaphore.emplace(device_);
+    }
+
+    uint64_t DeviceQueue::submit(vk::ArrayProxy<const vk::SubmitInfo> submits, vk::Fence fence) const
+    {
+        std::lock_guard lock{p_state->mutex};
+        if(!p_state->semaphore)
+        {
+            queue.submit(submits, fence);
+            return 0;
+        }
+
+        // A signal-only batch at the end covers every command submitted before it on this queue.
+        uint64_t value = p_state->submittedValue.load(std::memory_order_relaxed) + 1;
+        vk::Semaphore semaphore = *p_state->semaphore;
+        vk::TimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+        timelineSubmitInfo.setSignalSemaphoreValues(value);
+
+        std::vector<vk::SubmitInfo> submitInfos{ submits.begin(), submits.end() };
+        submitInfos.emplace_back(vk::SubmitInfo{}.setSignalSemaphores(semaphore).setPNext(&timelineSubmitInfo));
+
+        queue.submit(submitInfos, fence);
+        p_state->submittedValue.store(value, std::memory_order_release);
+        return value;
+    }
+
+    uint64_t DeviceQueue::submit2(vk::ArrayProxy<const vk::SubmitInfo2> submits, vk::Fence fence) const
+    {
+        std::lock_guard lock{p_state->mutex};
+        if(!p_state->semaphore)
+        {
+            queue.submit2(submits, fence);
+            return 0;
+        }
+
+        uint64_t value = p_state->submittedValue.load(std::memory_order_relaxed) + 1;
+        vk::SemaphoreSubmitInfo signalInfo{ *p_state->semaphore, value, vk::PipelineStageFlagBits2::eAllCommands };
+
+        std::vector<vk::SubmitInfo2> submitInfos{ submits.begin(), submits.end() };
+        submitInfos.emplace_back(vk::SubmitInfo2{}.setSignalSemaphoreInfos(signalInfo));
+
+        queue.submit2(submitInfos, fence);
+        p_state->submittedValue.store(value, std::memory_order_release);
+        return value;
+    }
+
+    vk::Result DeviceQueue::presentKHR(const vk::PresentInfoKHR& presentInfo) const
+    {
+        std::lock_guard lock{p_state->mutex};
+        return queue.presentKHR(presentInfo);
+    }
+
+    void DeviceQueue::waitIdle() const
+    {
+        std::lock_guard lock{p_state->mutex};
+        queue.waitIdle();
+    }
+
+    uint64_t DeviceQueue::getCompletedValue() const
+    {
+        return p_state->semaphore ? p_state->semaphore->getValue() : 0;
+    }
+
+    bool DeviceQueue::wait(uint64_t value, uint64_t timeout) const
+    {
+        return !p_state->semaphore || p_state->semaphore->wait(value, timeout);
+    }
 
     Device::Device(const vk::raii::Instance& instance, const CreateInfo& createInfo_)
     {
+        VKE_ZONE("Device::Device");
         auto physicalDevices = instance.enumeratePhysicalDevices();
+        auto physicalDeviceCapabilities = getPhysicalDeviceCapabilities(physicalDevices);
 
-        Selecter<vk::raii::PhysicalDevice> physicalDeviceSelecter{createInfo_.physicalDevicSelecter.f_, 
-            [&](const vk::raii::PhysicalDevice& p) -> bool
+        std::vector<std::vector<std::vector<DeviceQueueInfo>>> physicalDeviceQueueInfos = 
+            std::ranges::to<std::vector<std::vector<std::vector<DeviceQueueInfo>>>>(physicalDeviceCapabilities 
+                | std::ranges::views::transform(createInfo_.deviceQueueInfos));
+
+        auto getIndex = [&](const PhysicalDeviceCapabilities& p) -> size_t
+        {
+            return std::ranges::find(physicalDevices, *p.physicalDevice, [](const vk::raii::PhysicalDevice& d){ return *d; }) - physicalDevices.begin();
+        };
+
+        Selecter<PhysicalDeviceCapabilities> physicalDeviceSelecter{createInfo_.physicalDevicSelecter.f_, 
+            [&](const PhysicalDeviceCapabilities& p) -> bool
             {
-                return !createInfo_.deviceQueueInfos(p).empty() && createInfo_.physicalDevicSelecter.checker(p);
+                return !physicalDeviceQueueInfos[getIndex(p)].empty() && createInfo_.physicalDevicSelecter.checker(p);
             }};
 
-        physicalDevice = physicalDeviceSelecter(physicalDevices);
+        capabilities = physicalDeviceSelecter(physicalDeviceCapabilities);
+        const vk::raii::PhysicalDevice& physicalDevice = capabilities.physicalDevice;
 
-        deviceQueueInfos = createInfo_.deviceQueueInfos(physicalDevice);
+        deviceQueueInfos = std::move(physicalDeviceQueueInfos[getIndex(capabilities)]);
 
         std::vector<std::vector<float>> queuePriorities;
         queuePriorities.reserve(deviceQueueInfos.size());
@@ -107,20 +426,87 @@ namespace vke{
             }
         }
 
-        auto extensionProperties = physicalDevice.enumerateDeviceExtensionProperties();
+        const auto& extensionProperties = capabilities.extensions;
+
+        auto isExtensionSupported = [&](std::string_view extensionName) -> bool
+        {
+            return capabilities.isExtensionSupported(extensionName);
+        };
 
-        auto enabledExtensions = std::ranges::to<std::vector<const char*>>(extensionProperties
+        auto enableExtension = [&](const char* extensionName)
+        {
+            if(!isExtensionEnabled(extensionName))
+                enabledExtensions.emplace_back(extensionName);
+        };
+
+        enabledExtensions = std::ranges::to<std::vector<std::string>>(extensionProperties
             | std::ranges::views::filter(createInfo_.enabledExtensionChecker)
-            | std::ranges::views::transform([](const vk::ExtensionProperties& p) -> const char*{ return p.extensionName; }));
+            | std::ranges::views::transform([](const vk::ExtensionProperties& p) -> std::string { return p.extensionName.data(); }));
+
+        enableExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+        if(isExtensionSupported(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME))
+            enableExtension(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+
+        vk::StructureChain<vk::DeviceCreateInfo, vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceTimelineSemaphoreFeatures,
+            vk::PhysicalDeviceSynchronization2Features, vk::PhysicalDevicePresentIdFeaturesKHR, vk::PhysicalDevicePresentWaitFeaturesKHR> deviceCreateInfo{};
+
+        if(capabilities.properties.apiVersion < vk::ApiVersion12 && isExtensionSupported(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+            enableExtension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
 
-        enabledExtensions.emplace_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        bool timelineSemaphoreAvailable = capabilities.properties.apiVersion >= vk::ApiVersion12 ||
+            isExtensionEnabled(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+        enabledFeatures.timelineSemaphore = capabilities.timelineSemaphore && timelineSemaphoreAvailable;
+        if(timelineSemaphoreAvailable)
+            deviceCreateInfo.get<vk::PhysicalDeviceTimelineSemaphoreFeatures>().setTimelineSemaphore(enabledFeatures.timelineSemaphore);
+        else
+            deviceCreateInfo.unlink<vk::PhysicalDeviceTimelineSemaphoreFeatures>();
 
-        auto enabledFeatures = createInfo_.enabledFeaturesTransformer(physicalDevice.getFeatures());
+        if(isExtensionSupported(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+            enableExtension(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+
+        bool synchronization2Available = capabilities.properties.apiVersion >= vk::ApiVersion13 ||
+            isExtensionEnabled(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+        enabledFeatures.synchronization2 = capabilities.synchronization2 && synchronization2Available;
+        if(synchronization2Available)
+            deviceCreateInfo.get<vk::PhysicalDeviceSynchronization2Features>().setSynchronization2(enabledFeatures.synchronization2);
+        else
+            deviceCreateInfo.unlink<vk::PhysicalDeviceSynchronization2Features>();
+
+        if(isExtensionEnabled(VK_KHR_SWAPCHAIN_EXTENSION_NAME) && 
+            isExtensionSupported(VK_KHR_PRESENT_ID_EXTENSION_NAME) && isExtensionSupported(VK_KHR_PRESENT_WAIT_EXTENSION_NAME) &&
+            capabilities.presentId && 
+            capabilities.presentWait)
+        {
+            enableExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            enableExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        }
 
-        device = std::make_unique<vk::raii::Device>(physicalDevice, vk::DeviceCreateInfo{}
+        enabledFeatures.presentId = isExtensionEnabled(VK_KHR_PRESENT_ID_EXTENSION_NAME) && capabilities.presentId;
+        if(isExtensionEnabled(VK_KHR_PRESENT_ID_EXTENSION_NAME))
+            deviceCreateInfo.get<vk::PhysicalDevicePresentIdFeaturesKHR>().setPresentId(
+                enabledFeatures.presentId);
+        else
+            deviceCreateInfo.unlink<vk::PhysicalDevicePresentIdFeaturesKHR>();
+
+        enabledFeatures.presentWait = isExtensionEnabled(VK_KHR_PRESENT_WAIT_EXTENSION_NAME) && capabilities.presentWait;
+        if(isExtensionEnabled(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+            deviceCreateInfo.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().setPresentWait(
+                enabledFeatures.presentWait);
+        else
+            deviceCreateInfo.unlink<vk::PhysicalDevicePresentWaitFeaturesKHR>();
+
+        deviceCreateInfo.get<vk::PhysicalDeviceFeatures2>().setFeatures(
+            createInfo_.enabledFeaturesTransformer(capabilities.features));
+
+        auto extensionNames = std::ranges::to<std::vector<const char*>>(enabledExtensions
+            | std::ranges::views::transform([](const std::string& name) -> const char*{ return name.c_str(); }));
+
+        deviceCreateInfo.get<vk::DeviceCreateInfo>()
             .setQueueCreateInfos(queueCreateInfos)
-            .setPEnabledExtensionNames(enabledExtensions)
-            .setPEnabledFeatures(&enabledFeatures));
+            .setPEnabledExtensionNames(extensionNames);
+
+        device = std::make_unique<vk::raii::Device>(physicalDevice, deviceCreateInfo.get<vk::DeviceCreateInfo>());
 
         deviceQueues.resize(deviceQueueInfos.size());
         for(uint32_t queueFamilyIndex = 0; queueFamilyIndex < deviceQueueInfos.size(); queueFamilyIndex++)
@@ -131,7 +517,7 @@ namespace vke{
             queueFamilies.reserve(queueFamilyInfos.size());
             for(uint32_t queueIndex = 0; queueIndex < queueFamilyInfos.size(); queueIndex++)
             {
-                queueFamilies.emplace_back(DeviceQueue{*device, queueFamilyIndex, queueIndex});
+                queueFamilies.emplace_back(DeviceQueue{*device, queueFamilyIndex, queueIndex, enabledFeatures.timelineSemaphore});
             }
         }
     }
@@ -162,4 +548,9 @@ namespace vke{
 
         return deviceQueues[bestQueueFamilyIndex][bestQueueIndex];
     }
+
+    bool Device::isExtensionEnabled(std::string_view extensionName) const noexcept
+    {
+        return std::ranges::find(enabledExtensions, extensionName) != std::ranges::end(enabledExtensions);
+    }
 }
\ No newline at end of file
@@ -1,6 +1,14 @@
 #pragma once
 
 #include "Common.hpp"
+#include "Debug.hpp"
+#include "Synchronization.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
 
 namespace vke{
 
@@ -13,21 +21,27 @@ namespace vke{
             uint32_t applicationVersion = VK_MAKE_VERSION(0, 0, 0);
             Checker<vk::ExtensionProperties> enabledExtensionChecker{false};
             Checker<vk::LayerProperties> enabledLayerChecker{false};
+            DebugMessageQueue::CreateInfo debugMessageQueue{};
         };
 
         explicit Instance() = default;
         explicit Instance(const CreateInfo& createInfo);
 
         Instance(Instance&&) noexcept = default;
-        Instance& operator=(Instance&&) noexcept = default;
+        Instance& operator=(Instance&& other) noexcept;
 
         inline operator const vk::raii::Instance& () const & noexcept { return instance; }
         inline operator vk::Instance () const & noexcept { return instance; }
         inline const auto& operator->() const & noexcept { return instance; }
 
+        bool isExtensionEnabled(std::string_view extensionName) const noexcept;
+        inline DebugMessageQueue* getDebugMessageQueue() const noexcept { return debugMessageQueue.get(); }
+
     private:
         vk::raii::Context context{};
+        std::unique_ptr<DebugMessageQueue> debugMessageQueue{};
         vk::raii::Instance instance{nullptr};
+        std::vector<std::string> enabledExtensions;
 #ifdef _DEBUG
         vk::raii::DebugUtilsMessengerEXT debugMessenger{nullptr};
 #endif
@@ -46,28 +60,81 @@ namespace vke{
     class DeviceQueue
     {
     public:
-        DeviceQueue(const vk::raii::Device& device, uint32_t queueFamilyIndex, uint32_t queueIndex);
+        DeviceQueue(const vk::raii::Device& device, uint32_t queueFamilyIndex, uint32_t queueIndex, bool timelineSemaphore = false);
         
-        inline operator const vk::raii::Queue&() const & noexcept { return queue; }
         inline operator vk::Queue () const & noexcept { return queue; }
-        inline const auto* operator->() const & noexcept { return &queue; }
 
         inline uint32_t getQueueFamilyIndex() const noexcept { return queueFamilyIndex; }
         inline uint32_t getQueueIndex() const noexcept { return queueIndex; }
 
+        // Hold while passing the raw handle to Vulkan calls that need external queue synchronization.
+        inline std::unique_lock<std::mutex> lock() const { return std::unique_lock{p_state->mutex}; }
+
+        // With a timeline, every submit also signals the queue's semaphore and returns the signalled value.
+        uint64_t submit(vk::ArrayProxy<const vk::SubmitInfo> submits, vk::Fence fence = {}) const;
+        uint64_t submit2(vk::ArrayProxy<const vk::SubmitInfo2> submits, vk::Fence fence = {}) const;
+        vk::Result presentKHR(const vk::PresentInfoKHR& presentInfo) const;
+        void waitIdle() const;
+
+        inline bool hasTimeline() const noexcept { return p_state->semaphore.has_value(); }
+        inline vk::Semaphore getSemaphore() const noexcept { return p_state->semaphore ? vk::Semaphore{*p_state->semaphore} : vk::Semaphore{}; }
+        inline uint64_t getSubmittedValue() const noexcept { return p_state->submittedValue.load(std::memory_order_acquire); }
+        uint64_t getCompletedValue() const;
+        bool wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
     private:
+        struct State
+        {
+            std::mutex mutex;
+            std::optional<TimelineSemaphore> semaphore;
+            std::atomic<uint64_t> submittedValue{0};
+        };
+
         uint32_t queueFamilyIndex = 0;
         uint32_t queueIndex = 0;
         vk::raii::Queue queue{ nullptr };
+        std::unique_ptr<State> p_state = std::make_unique<State>();
+    };
+
+    struct PhysicalDeviceCapabilities
+    {
+        vk::raii::PhysicalDevice physicalDevice{nullptr};
+        vk::PhysicalDeviceProperties properties{};
+        vk::PhysicalDeviceFeatures features{};
+        vk::PhysicalDeviceMemoryProperties memoryProperties{};
+        std::vector<vk::ExtensionProperties> extensions;
+        std::vector<vk::QueueFamilyProperties> queueFamilies;
+        bool timelineSemaphore = false;
+        bool synchronization2 = false;
+        bool presentId = false;
+        bool presentWait = false;
+
+        bool isExtensionSupported(std::string_view extensionName) const noexcept;
+
+        inline operator const vk::raii::PhysicalDevice& () const & noexcept { return physicalDevice; }
+        inline const auto* operator->() const & noexcept { return &physicalDevice; }
     };
 
+    std::vector<PhysicalDeviceCapabilities> getPhysicalDeviceCapabilities(std::span<const vk::raii::PhysicalDevice> physicalDevices);
+    void loadPhysicalDeviceCapabilities(const std::filesystem::path& path);
+    void savePhysicalDeviceCapabilities(const std::filesystem::path& path);
+    void clearPhysicalDeviceCapabilities();
+
     class Device
     {
     public:
+        struct EnabledFeatures
+        {
+            bool timelineSemaphore = false;
+            bool synchronization2 = false;
+            bool presentId = false;
+            bool presentWait = false;
+        };
+
         struct CreateInfo
         {
-            Selecter<vk::raii::PhysicalDevice> physicalDevicSelecter;
-            Getter<std::vector<std::vector<DeviceQueueInfo>>(const vk::raii::PhysicalDevice&)> deviceQueueInfos{std::vector<std::vector<DeviceQueueInfo>>{ {{0xffffffff, 1.0f}} }};
+            Selecter<PhysicalDeviceCapabilities> physicalDevicSelecter;
+            Getter<std::vector<std::vector<DeviceQueueInfo>>(const PhysicalDeviceCapabilities&)> deviceQueueInfos{std::vector<std::vector<DeviceQueueInfo>>{ {{0xffffffff, 1.0f}} }};
             Checker<vk::ExtensionProperties> enabledExtensionChecker{false};
             Getter<vk::PhysicalDeviceFeatures(const vk::PhysicalDeviceFeatures&)> enabledFeaturesTransformer{ vk::PhysicalDeviceFeatures{} };
         };
@@ -81,12 +148,23 @@ namespace vke{
         inline operator vk::Device () const & noexcept { return *device; }
         inline const auto* operator->() const & noexcept { return device.get(); }
 
-        inline const vk::raii::PhysicalDevice& getPhysicalDevice() const & noexcept { return physicalDevice; }
+        inline const vk::raii::PhysicalDevice& getPhysicalDevice() const & noexcept { return capabilities.physicalDevice; }
+        inline const PhysicalDeviceCapabilities& getCapabilities() const & noexcept { return capabilities; }
 
         const DeviceQueue& getDeviceQueue(const std::function<uint32_t(const DeviceQueueInfo&)>& queueEvaluationFunction) const &;
+        inline std::span<const DeviceQueue> getDeviceQueues(uint32_t queueFamilyIndex) const & noexcept 
+        { 
+            return queueFamilyIndex < deviceQueues.size() ? std::span<const DeviceQueue>{deviceQueues[queueFamilyIndex]} : std::span<const DeviceQueue>{}; 
+        }
+        inline const std::vector<std::vector<DeviceQueueInfo>>& getDeviceQueueInfos() const & noexcept { return deviceQueueInfos; }
+
+        bool isExtensionEnabled(std::string_view extensionName) const noexcept;
+        inline const EnabledFeatures& getEnabledFeatures() const noexcept { return enabledFeatures; }
 
     private:
-        vk::raii::PhysicalDevice physicalDevice{nullptr};
+        PhysicalDeviceCapabilities capabilities{};
+        std::vector<std::string> enabledExtensions;
+        EnabledFeatures enabledFeatures{};
         std::vector<std::vector<DeviceQueueInfo>> deviceQueueInfos;
         std::vector<std::vector<DeviceQueue>> deviceQueues;
         std::unique_ptr<vk::raii::Device> device{nullptr};
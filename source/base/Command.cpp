@@ -0,0 +1,95 @@
+#include "Command.hpp"
+
+namespace vke{
+    namespace{
+        std::atomic<uint64_t> command_pool_manager_id{0};
+
+        struct ThreadPoolsCache
+        {
+            uint64_t id = 0;
+            void* p_pools = nullptr;
+        };
+        thread_local ThreadPoolsCache thread_pools_cache{};
+    }
+
+    CommandPoolManager::CommandPoolManager(const vk::raii::Device& device, const CreateInfo& createInfo)
+        : p_device{&device}, framesInFlight{std::max(createInfo.framesInFlight, 1u)}, 
+        id{command_pool_manager_id.fetch_add(1, std::memory_order_relaxed) + 1},
+        frameEpochs{std::make_unique<std::atomic<uint64_t>[]>(framesInFlight)} {}
+
+    CommandPoolManager::CommandPoolManager(const Device& device, const CreateInfo& createInfo)
+        : CommandPoolManager{static_cast<const vk::raii::Device&>(device), createInfo} {}
+
+    void CommandPoolManager::beginFrame(uint32_t frameIndex_)
+    {
+        frameIndex_ %= framesInFlight;
+        frameEpochs[frameIndex_].fetch_add(1, std::memory_order_acq_rel);
+        frameIndex.store(frameIndex_, std::memory_order_release);
+    }
+
+    const vk::raii::CommandBuffer& CommandPoolManager::allocate(uint32_t queueFamilyIndex, vk::CommandBufferLevel level)
+    {
+        uint32_t currentFrame = frameIndex.load(std::memory_order_acquire);
+        uint64_t epoch = frameEpochs[currentFrame].load(std::memory_order_acquire);
+
+        Pool& pool = getThreadPools().frames[currentFrame][queueFamilyIndex];
+        if(!*pool.commandPool)
+        {
+            pool.commandPool = vk::raii::CommandPool{ *p_device, 
+                vk::CommandPoolCreateInfo{ vk::CommandPoolCreateFlagBits::eTransient, queueFamilyIndex } };
+            pool.epoch = epoch;
+        }
+        else if(pool.epoch != epoch)
+        {
+            pool.commandPool.reset();
+            pool.usedPrimaryCount = 0;
+            pool.usedSecondaryCount = 0;
+            pool.epoch = epoch;
+        }
+
+        bool primary = level == vk::CommandBufferLevel::ePrimary;
+        auto& commandBuffers = primary ? pool.primaryCommandBuffers : pool.secondaryCommandBuffers;
+        size_t& usedCount = primary ? pool.usedPrimaryCount : pool.usedSecondaryCount;
+
+        if(usedCount == commandBuffers.size())
+        {
+            uint32_t count = static_cast<uint32_t>(std::max<size_t>(commandBuffers.size(), 4));
+            vk::raii::CommandBuffers allocated{ *p_device, vk::CommandBufferAllocateInfo{ *pool.commandPool, level, count } };
+            std::ranges::move(allocated, std::back_inserter(commandBuffers));
+        }
+
+        return commandBuffers[usedCount++];
+    }
+
+    size_t CommandPoolManager::getPoolCount() const
+    {
+        std::lock_guard lock{mutex};
+
+        size_t count = 0;
+        for(const auto& [_, pools] : threadPools)
+        {
+            for(const auto& frame : pools->frames)
+            {
+                count += frame.size();
+            }
+        }
+        return count;
+    }
+
+    CommandPoolManager::ThreadPools& CommandPoolManager::getThreadPools()
+    {
+        if(thread_pools_cache.id == id)
+            return *static_cast<ThreadPools*>(thread_pools_cache.p_pools);
+
+        std::lock_guard lock{mutex};
+        auto& pools = threadPools[std::this_thread::get_id()];
+        if(!pools)
+        {
+            pools = std::make_unique<ThreadPools>();
+            pools->frames.resize(framesInFlight);
+        }
+
+        thread_pools_cache = { id, pools.get() };
+        return *pools;
+    }
+}
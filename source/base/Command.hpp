@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace vke{
+
+    class CommandPoolManager
+    {
+    public:
+        struct CreateInfo
+        {
+            uint32_t framesInFlight = 2;
+        };
+
+        CommandPoolManager(const vk::raii::Device& device, const CreateInfo& createInfo);
+        CommandPoolManager(const Device& device, const CreateInfo& createInfo);
+
+        CommandPoolManager(const CommandPoolManager&) = delete;
+        CommandPoolManager& operator=(const CommandPoolManager&) = delete;
+
+        void beginFrame(uint32_t frameIndex);
+        const vk::raii::CommandBuffer& allocate(uint32_t queueFamilyIndex, vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
+
+        inline uint32_t getFrameIndex() const noexcept { return frameIndex.load(std::memory_order_acquire); }
+        inline uint32_t getFramesInFlight() const noexcept { return framesInFlight; }
+        size_t getPoolCount() const;
+
+    private:
+        struct Pool
+        {
+            vk::raii::CommandPool commandPool{ nullptr };
+            std::deque<vk::raii::CommandBuffer> primaryCommandBuffers;
+            std::deque<vk::raii::CommandBuffer> secondaryCommandBuffers;
+            size_t usedPrimaryCount = 0;
+            size_t usedSecondaryCount = 0;
+            uint64_t epoch = 0;
+        };
+
+        struct ThreadPools
+        {
+            std::vector<std::map<uint32_t, Pool>> frames;
+        };
+
+        const vk::raii::Device* p_device = nullptr;
+        uint32_t framesInFlight = 0;
+        uint64_t id = 0;
+        std::atomic<uint32_t> frameIndex{0};
+        std::unique_ptr<std::atomic<uint64_t>[]> frameEpochs;
+
+        mutable std::mutex mutex;
+        std::map<std::thread::id, std::unique_ptr<ThreadPools>> threadPools;
+
+        ThreadPools& getThreadPools();
+    };
+
+}
@@ -0,0 +1,292 @@
+#include "Debug.hpp"
+
+#include <bit>
+#include <cstring>
+#include <format>
+#include <fstream>
+
+namespace vke{
+    namespace{
+        template<size_t N>
+        void copyString(std::array<char, N>& destination, const char* source) noexcept
+        {
+            constexpr std::string_view marker = "...";
+
+            size_t length = source ? strnlen(source, N - 1) : 0;
+            if(length)
+                std::memcpy(destination.data(), source, length);
+            destination[length] = '\0';
+
+            if(length == N - 1 && source[length] != '\0' && length >= marker.size())
+                std::memcpy(destination.data() + length - marker.size(), marker.data(), marker.size());
+        }
+    }
+
+    DebugMessageQueue::DebugMessageQueue(const CreateInfo& createInfo)
+        : maxMessagesPerSecond{createInfo.maxMessagesPerSecond}, 
+        deduplicationInterval{createInfo.deduplicationInterval}, sinks{createInfo.sinks}, 
+        tokens{static_cast<double>(createInfo.maxMessagesPerSecond)}, lastRefill{std::chrono::steady_clock::now()}
+    {
+        size_t capacity = std::bit_ceil(std::max<size_t>(createInfo.capacity, 2));
+        mask = capacity - 1;
+        cells = std::make_unique<Cell[]>(capacity);
+        for(size_t i = 0; i < capacity; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        thread = std::jthread{[this]{ run(); }};
+    }
+
+    DebugMessageQueue::~DebugMessageQueue()
+    {
+        stopping.store(true, std::memory_order_release);
+        wakeCount.fetch_add(1, std::memory_order_release);
+        wakeCount.notify_one();
+        thread.join();
+    }
+
+    bool DebugMessageQueue::push(vk::DebugUtilsMessageSeverityFlagBitsEXT severity, vk::DebugUtilsMessageTypeFlagsEXT type, 
+        const vk::DebugUtilsMessengerCallbackDataEXT& callbackData) noexcept
+    {
+        receivedCount.fetch_add(1, std::memory_order_relaxed);
+
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+
+        while(true)
+        {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if(difference == 0)
+            {
+                if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if(difference < 0)
+            {
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->severity = severity;
+        cell->type = type;
+        cell->messageIdNumber = callbackData.messageIdNumber;
+        cell->time = std::chrono::steady_clock::now();
+        copyString(cell->messageIdName, callbackData.pMessageIdName);
+        copyString(cell->text, callbackData.pMessage);
+        cell->sequence.store(position + 1, std::memory_order_release);
+
+        wakeCount.fetch_add(1, std::memory_order_release);
+        wakeCount.notify_one();
+        return true;
+    }
+
+    void DebugMessageQueue::addSink(Sink sink)
+    {
+        std::lock_guard lock{mutex};
+        sinks.push_back(std::move(sink));
+    }
+
+    void DebugMessageQueue::flush()
+    {
+        size_t target = enqueuePosition.load(std::memory_order_acquire);
+
+        size_t processed = processedPosition.load(std::memory_order_acquire);
+        while(processed < target)
+        {
+            processedPosition.wait(processed, std::memory_order_acquire);
+            processed = processedPosition.load(std::memory_order_acquire);
+        }
+
+        std::vector<Message> output{};
+        std::lock_guard lock{mutex};
+        emitPending(output);
+        emit(output);
+    }
+
+    DebugMessageQueue::Statistics DebugMessageQueue::getStatistics() const noexcept
+    {
+        return Statistics{
+            .receivedCount = receivedCount.load(std::memory_order_relaxed),
+            .emittedCount = emittedCount.load(std::memory_order_relaxed),
+            .deduplicatedCount = deduplicatedCount.load(std::memory_order_relaxed),
+            .rateLimitedCount = rateLimitedCount.load(std::memory_order_relaxed),
+            .droppedCount = droppedCount.load(std::memory_order_relaxed) };
+    }
+
+    std::vector<std::pair<std::string, uint64_t>> DebugMessageQueue::getMessageCounts() const
+    {
+        std::lock_guard lock{mutex};
+
+        std::vector<std::pair<std::string, uint64_t>> counts{};
+        counts.reserve(entries.size());
+        for(const auto& [key, entry] : entries)
+        {
+            counts.emplace_back(key, entry.totalCount);
+        }
+        std::ranges::sort(counts, std::ranges::greater{}, &std::pair<std::string, uint64_t>::second);
+        return counts;
+    }
+
+    std::string DebugMessageQueue::format(const Message& message)
+    {
+        std::string text = std::format("[{}][{}] ", vk::to_string(message.severity), vk::to_string(message.type));
+        if(!message.messageIdName.empty())
+            text += std::format("{} (0x{:08x}): ", message.messageIdName, static_cast<uint32_t>(message.messageIdNumber));
+        text += message.text;
+        if(message.count > 1)
+            text += std::format(" [x{}]", message.count);
+        return text;
+    }
+
+    DebugMessageQueue::Sink DebugMessageQueue::createStreamSink(std::ostream& stream)
+    {
+        return [&stream](std::span<const Message> messages)
+        {
+            for(const Message& message : messages)
+            {
+                stream << format(message) << '\n';
+            }
+            stream.flush();
+        };
+    }
+
+    DebugMessageQueue::Sink DebugMessageQueue::createFileSink(const std::filesystem::path& path)
+    {
+        auto stream = std::make_shared<std::ofstream>(path, std::ios::trunc);
+        if(!*stream)
+            throw std::runtime_error{std::format("vke::DebugMessageQueue::createFileSink, Failed to open {}", path.string())};
+
+        return [stream](std::span<const Message> messages)
+        {
+            for(const Message& message : messages)
+            {
+                *stream << format(message) << '\n';
+            }
+            stream->flush();
+        };
+    }
+
+    VKAPI_ATTR vk::Bool32 VKAPI_CALL DebugMessageQueue::callback(vk::DebugUtilsMessageSeverityFlagBitsEXT messageSeverity, 
+        vk::DebugUtilsMessageTypeFlagsEXT messageType, const vk::DebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData)
+    {
+        if(pUserData && pCallbackData)
+            static_cast<DebugMessageQueue*>(pUserData)->push(messageSeverity, messageType, *pCallbackData);
+        return vk::False;
+    }
+
+    void DebugMessageQueue::run()
+    {
+        std::vector<Message> output{};
+
+        while(true)
+        {
+            uint64_t wake = wakeCount.load(std::memory_order_acquire);
+
+            size_t position = processedPosition.load(std::memory_order_relaxed);
+            size_t start = position;
+            {
+                std::lock_guard lock{mutex};
+                while(true)
+                {
+                    Cell& cell = cells[position & mask];
+                    if(cell.sequence.load(std::memory_order_acquire) != position + 1)
+                        break;
+
+                    process(cell, output);
+                    cell.sequence.store(position + mask + 1, std::memory_order_release);
+                    ++position;
+                }
+
+                if(position == start && stopping.load(std::memory_order_acquire))
+                    emitPending(output);
+
+                emit(output);
+            }
+            output.clear();
+
+            if(position == start)
+            {
+                if(stopping.load(std::memory_order_acquire))
+                    return;
+                wakeCount.wait(wake, std::memory_order_acquire);
+                continue;
+            }
+
+            processedPosition.store(position, std::memory_order_release);
+            processedPosition.notify_all();
+        }
+    }
+
+    void DebugMessageQueue::process(const Cell& cell, std::vector<Message>& output)
+    {
+        std::string key = cell.messageIdName[0] ? std::string{cell.messageIdName.data()} : 
+            cell.messageIdNumber ? std::format("0x{:08x}", static_cast<uint32_t>(cell.messageIdNumber)) : std::string{cell.text.data()};
+
+        auto [it, inserted] = entries.try_emplace(std::move(key));
+        Entry& entry = it->second;
+        entry.totalCount++;
+
+        if(!inserted && cell.time - entry.message.time < deduplicationInterval)
+        {
+            entry.pendingCount++;
+            deduplicatedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        entry.message = Message{ cell.severity, cell.type, cell.messageIdNumber, cell.messageIdName.data(), cell.text.data(), entry.pendingCount + 1, cell.time };
+        entry.pendingCount = 0;
+
+        if(maxMessagesPerSecond)
+        {
+            auto now = std::chrono::steady_clock::now();
+            tokens = std::min<double>(maxMessagesPerSecond, 
+                tokens + std::chrono::duration<double>(now - lastRefill).count() * maxMessagesPerSecond);
+            lastRefill = now;
+
+            if(tokens < 1.0)
+            {
+                entry.pendingCount = entry.message.count;
+                rateLimitedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            tokens -= 1.0;
+        }
+
+        output.push_back(entry.message);
+    }
+
+    void DebugMessageQueue::emitPending(std::vector<Message>& output)
+    {
+        for(auto& [key, entry] : entries)
+        {
+            if(entry.pendingCount == 0)
+                continue;
+
+            Message message = entry.message;
+            message.count = entry.pendingCount;
+            entry.pendingCount = 0;
+            output.push_back(std::move(message));
+        }
+    }
+
+    void DebugMessageQueue::emit(std::span<const Message> messages)
+    {
+        if(messages.empty())
+            return;
+
+        emittedCount.fetch_add(messages.size(), std::memory_order_relaxed);
+        for(const Sink& sink : sinks)
+        {
+            sink(messages);
+        }
+    }
+}
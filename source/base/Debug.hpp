@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace vke{
+
+    class DebugMessageQueue
+    {
+    public:
+        struct Message
+        {
+            vk::DebugUtilsMessageSeverityFlagBitsEXT severity = vk::DebugUtilsMessageSeverityFlagBitsEXT::eInfo;
+            vk::DebugUtilsMessageTypeFlagsEXT type{};
+            int32_t messageIdNumber = 0;
+            std::string messageIdName;
+            std::string text;
+            uint64_t count = 1;
+            std::chrono::steady_clock::time_point time{};
+        };
+
+        using Sink = std::function<void(std::span<const Message> messages)>;
+
+        struct CreateInfo
+        {
+            size_t capacity = 256;
+            uint32_t maxMessagesPerSecond = 100;
+            std::chrono::milliseconds deduplicationInterval{1000};
+            std::vector<Sink> sinks{};
+        };
+
+        struct Statistics
+        {
+            uint64_t receivedCount = 0;
+            uint64_t emittedCount = 0;
+            uint64_t deduplicatedCount = 0;
+            uint64_t rateLimitedCount = 0;
+            uint64_t droppedCount = 0;
+        };
+
+        explicit DebugMessageQueue(const CreateInfo& createInfo);
+        ~DebugMessageQueue();
+
+        DebugMessageQueue(const DebugMessageQueue&) = delete;
+        DebugMessageQueue& operator=(const DebugMessageQueue&) = delete;
+
+        bool push(vk::DebugUtilsMessageSeverityFlagBitsEXT severity, vk::DebugUtilsMessageTypeFlagsEXT type, 
+            const vk::DebugUtilsMessengerCallbackDataEXT& callbackData) noexcept;
+        void addSink(Sink sink);
+        void flush();
+
+        Statistics getStatistics() const noexcept;
+        std::vector<std::pair<std::string, uint64_t>> getMessageCounts() const;
+
+        static std::string format(const Message& message);
+        static Sink createStreamSink(std::ostream& stream);
+        static Sink createFileSink(const std::filesystem::path& path);
+
+        static VKAPI_ATTR vk::Bool32 VKAPI_CALL callback(vk::DebugUtilsMessageSeverityFlagBitsEXT messageSeverity, 
+            vk::DebugUtilsMessageTypeFlagsEXT messageType, const vk::DebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData);
+
+    private:
+        static constexpr size_t maxTextLength = 4096;
+        static constexpr size_t maxMessageIdNameLength = 128;
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence{0};
+            vk::DebugUtilsMessageSeverityFlagBitsEXT severity{};
+            vk::DebugUtilsMessageTypeFlagsEXT type{};
+            int32_t messageIdNumber = 0;
+            std::chrono::steady_clock::time_point time{};
+            std::array<char, maxMessageIdNameLength> messageIdName{};
+            std::array<char, maxTextLength> text{};
+        };
+
+        struct Entry
+        {
+            Message message;
+            uint64_t pendingCount = 0;
+            uint64_t totalCount = 0;
+        };
+
+        size_t mask = 0;
+        uint32_t maxMessagesPerSecond = 0;
+        std::chrono::steady_clock::duration deduplicationInterval{};
+        std::unique_ptr<Cell[]> cells;
+        alignas(64) std::atomic<size_t> enqueuePosition{0};
+        alignas(64) std::atomic<size_t> processedPosition{0};
+        std::atomic<uint64_t> wakeCount{0};
+        std::atomic<bool> stopping{false};
+        std::atomic<uint64_t> receivedCount{0};
+        std::atomic<uint64_t> emittedCount{0};
+        std::atomic<uint64_t> deduplicatedCount{0};
+        std::atomic<uint64_t> rateLimitedCount{0};
+        std::atomic<uint64_t> droppedCount{0};
+
+        mutable std::mutex mutex;
+        std::vector<Sink> sinks;
+        std::unordered_map<std::string, Entry> entries;
+        double tokens = 0.0;
+        std::chrono::steady_clock::time_point lastRefill{};
+
+        std::jthread thread;
+
+        void run();
+        void process(const Cell& cell, std::vector<Message>& output);
+        void emitPending(std::vector<Message>& output);
+        void emit(std::span<const Message> messages);
+    };
+
+}
@@ -0,0 +1,137 @@
+#include "Instrumentation.hpp"
+
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace vke{
+    namespace{
+        struct TraceRegistry
+        {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<TraceRing>> rings;
+            TraceSink sink;
+            uint32_t nextThreadId = 1;
+            uint64_t originTicks = getTraceTicks();
+            int64_t originTime = getTraceTime();
+        };
+
+        TraceRegistry& getTraceRegistry()
+        {
+            static TraceRegistry registry{};
+            return registry;
+        }
+
+        thread_local std::shared_ptr<TraceRing> thread_trace_ring_owner = nullptr;
+        thread_local TraceRing* thread_trace_ring = nullptr;
+    }
+
+    size_t TraceRing::drain(std::vector<TraceRecord>& output)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+        for(size_t i = t; i < h; ++i)
+        {
+            output.push_back(records[i & (capacity - 1)]);
+        }
+        tail.store(h, std::memory_order_release);
+        return h - t;
+    }
+
+    TraceRing& getThreadTraceRing()
+    {
+        if(thread_trace_ring)
+            return *thread_trace_ring;
+
+        TraceRegistry& registry = getTraceRegistry();
+        std::lock_guard lock{registry.mutex};
+        auto ring = std::make_shared<TraceRing>(registry.nextThreadId++);
+        registry.rings.push_back(ring);
+        thread_trace_ring = ring.get();
+        thread_trace_ring_owner = std::move(ring);
+        return *thread_trace_ring;
+    }
+
+    void setTraceSink(TraceSink sink)
+    {
+        TraceRegistry& registry = getTraceRegistry();
+        std::lock_guard lock{registry.mutex};
+        registry.sink = std::move(sink);
+    }
+
+    std::vector<TraceEvent> collectTrace()
+    {
+        TraceRegistry& registry = getTraceRegistry();
+        std::vector<TraceEvent> events{};
+        std::vector<TraceRecord> records{};
+
+        std::lock_guard lock{registry.mutex};
+
+        uint64_t nowTicks = getTraceTicks();
+        int64_t nowTime = getTraceTime();
+        double nanosecondsPerTick = nowTicks > registry.originTicks ? 
+            static_cast<double>(nowTime - registry.originTime) / static_cast<double>(nowTicks - registry.originTicks) : 1.0;
+        auto toTime = [&](uint64_t ticks) -> int64_t
+        {
+            return registry.originTime + static_cast<int64_t>(static_cast<double>(static_cast<int64_t>(ticks - registry.originTicks)) * nanosecondsPerTick);
+        };
+
+        for(const auto& ring : registry.rings)
+        {
+            records.clear();
+            ring->drain(records);
+            for(const TraceRecord& record : records)
+            {
+                events.push_back(TraceEvent{ 
+                    .name = record.name, 
+                    .processId = 0, 
+                    .threadId = ring->getThreadId(), 
+                    .begin = toTime(record.begin), 
+                    .end = toTime(record.end), 
+                    .type = record.type, 
+                    .value = record.value });
+            }
+        }
+
+        std::erase_if(registry.rings, [](const std::shared_ptr<TraceRing>& ring){ return ring.use_count() == 1; });
+        return events;
+    }
+
+    void flushTrace()
+    {
+        std::vector<TraceEvent> events = collectTrace();
+
+        TraceSink sink{};
+        {
+            TraceRegistry& registry = getTraceRegistry();
+            std::lock_guard lock{registry.mutex};
+            sink = registry.sink;
+        }
+
+        if(sink && !events.empty())
+            sink(events);
+    }
+
+    void flushTrace(const std::filesystem::path& path)
+    {
+        std::ofstream stream{path, std::ios::trunc};
+        if(!stream)
+            throw std::runtime_error{std::format("vke::flushTrace, Failed to open {}", path.string())};
+        writeChromeTrace(stream, collectTrace());
+    }
+
+    uint64_t getDroppedTraceCount()
+    {
+        TraceRegistry& registry = getTraceRegistry();
+        std::lock_guard lock{registry.mutex};
+
+        uint64_t dropped = 0;
+        for(const auto& ring : registry.rings)
+        {
+            dropped += ring->getDroppedCount();
+        }
+        return dropped;
+    }
+}
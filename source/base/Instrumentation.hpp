@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Trace.hpp"
+
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace vke{
+
+    struct TraceRecord
+    {
+        const char* name = nullptr;
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        int64_t value = 0;
+        TraceEvent::Type type = TraceEvent::Type::eZone;
+    };
+
+    class TraceRing
+    {
+    public:
+        static constexpr size_t capacity = 1 << 14;
+
+        explicit TraceRing(uint32_t threadId) noexcept : threadId{threadId} {}
+
+        inline void push(const TraceRecord& record) noexcept
+        {
+            size_t h = head.load(std::memory_order_relaxed);
+            if(h - tail.load(std::memory_order_acquire) >= capacity)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            records[h & (capacity - 1)] = record;
+            head.store(h + 1, std::memory_order_release);
+        }
+
+        size_t drain(std::vector<TraceRecord>& output);
+
+        inline uint32_t getThreadId() const noexcept { return threadId; }
+        inline uint64_t getDroppedCount() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    private:
+        uint32_t threadId = 0;
+        std::array<TraceRecord, capacity> records{};
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    using TraceSink = std::function<void(std::span<const TraceEvent> events)>;
+
+    TraceRing& getThreadTraceRing();
+    void setTraceSink(TraceSink sink);
+    std::vector<TraceEvent> collectTrace();
+    void flushTrace();
+    void flushTrace(const std::filesystem::path& path);
+    uint64_t getDroppedTraceCount();
+
+    inline uint64_t getTraceTicks() noexcept
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(getTraceTime());
+#endif
+    }
+
+    class TraceZone
+    {
+    public:
+        explicit TraceZone(const char* name) noexcept : name{name}, begin{getTraceTicks()} {}
+        ~TraceZone() { getThreadTraceRing().push(TraceRecord{ name, begin, getTraceTicks(), 0, TraceEvent::Type::eZone }); }
+
+        TraceZone(const TraceZone&) = delete;
+        TraceZone& operator=(const TraceZone&) = delete;
+
+    private:
+        const char* name;
+        uint64_t begin;
+    };
+
+    inline void traceCounter(const char* name, int64_t value)
+    {
+        uint64_t ticks = getTraceTicks();
+        getThreadTraceRing().push(TraceRecord{ name, ticks, ticks, value, TraceEvent::Type::eCounter });
+    }
+
+}
+
+#define VKE_TRACE_CONCAT_IMPL(a, b) a##b
+#define VKE_TRACE_CONCAT(a, b) VKE_TRACE_CONCAT_IMPL(a, b)
+
+#if defined(VKE_INSTRUMENTATION)
+#define VKE_ZONE(name) ::vke::TraceZone VKE_TRACE_CONCAT(vke_trace_zone_, __LINE__){ name }
+#define VKE_COUNTER(name, value) ::vke::traceCounter(name, static_cast<int64_t>(value))
+#else
+#define VKE_ZONE(name) static_cast<void>(0)
+#define VKE_COUNTER(name, value) static_cast<void>(0)
+#endif
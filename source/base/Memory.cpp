@@ -1,12 +1,30 @@
 #include "Memory.hpp"
+#include "Instrumentation.hpp"
 
 #include <bit>
 
 namespace vke{
     DeviceMemoryResource* default_device_memory_res = nullptr;
 
+    namespace{
+        vk::MappedMemoryRange getMappedMemoryRange(const DeviceMemoryInfo& memory)
+        {
+            vk::DeviceSize atomSize = std::max<vk::DeviceSize>(memory.nonCoherentAtomSize, 1);
+            vk::DeviceSize offset = memory.offset / atomSize * atomSize;
+            vk::DeviceSize size = (memory.offset + memory.size - offset + atomSize - 1) / atomSize * atomSize;
+
+            // A rounded-up size may run past the allocation, the rest of the mapping is the valid alternative.
+            if(offset + size > memory.offset + memory.size)
+                size = VK_WHOLE_SIZE;
+
+            return vk::MappedMemoryRange{*memory.memory, offset, size};
+        }
+    }
+
     DeviceMemoryInfo DeviceMemoryResource::allocate(vk::MemoryRequirements requirements)
     {
+        VKE_ZONE("DeviceMemoryResource::allocate");
+        VKE_COUNTER("DeviceMemoryResource::allocate size", requirements.size);
         if(!std::has_single_bit(requirements.alignment))
         {
             throw std::runtime_error{"DeviceMemoryResource::allocate alignment must be a power of two"};
@@ -112,7 +130,7 @@ namespace vke{
     }
     
     MappedDeviceMemoryResource::MappedDeviceMemoryResource(const vk::raii::PhysicalDevice& physicalDevice, DeviceMemoryResource* upstream)
-        : p_resource{upstream}
+        : p_resource{upstream}, nonCoherentAtomSize{physicalDevice.getProperties().limits.nonCoherentAtomSize}
     {
         auto properties = physicalDevice.getMemoryProperties();
 
@@ -141,33 +159,17 @@ namespace vke{
 
         DeviceMemoryInfo p = p_resource->allocate(vk::MemoryRequirements{requirements.size, requirements.alignment, indices});
         p.mapped = p.memory->mapMemory(0, requirements.size);
+        p.hostCoherent = (coherentIndices & ( 1u << p.memoryIndex )) != 0;
+        p.nonCoherentAtomSize = nonCoherentAtomSize;
 
-        if( (coherentIndices & ( 1u << p.memoryIndex )) == 0 )
-        {
-            vk::MappedMemoryRange range{*p.memory, p.offset, requirements.size};
-
-            VULKAN_HPP_ASSERT( p.memory->getDispatcher()->vkInvalidateMappedMemoryRanges && "Function <vkInvalidateMappedMemoryRanges> requires <VK_VERSION_1_0>" );
-
-            vk::Result result = static_cast<vk::Result>( p.memory->getDispatcher()->vkInvalidateMappedMemoryRanges( 
-                static_cast<VkDevice>( p.memory->getDevice() ), 1, reinterpret_cast<VkMappedMemoryRange*>(&range)) );
-            vk::detail::resultCheck( result, "vke::MappedDeviceMemoryResource::do_allocate" );
-        }
+        invalidateMappedMemory(p);
 
         return p;
     }
 
     void MappedDeviceMemoryResource::do_deallocate(DeviceMemoryInfo memory)
     {
-        if( (coherentIndices & ( 1u << memory.memoryIndex )) == 0 )
-        {
-            vk::MappedMemoryRange range{*memory.memory, memory.offset, memory.size};
-
-            VULKAN_HPP_ASSERT( memory.memory->getDispatcher()->vkFlushMappedMemoryRanges && "Function <vkFlushMappedMemoryRanges> requires <VK_VERSION_1_0>" );
-
-            vk::Result result = static_cast<vk::Result>( memory.memory->getDispatcher()->vkFlushMappedMemoryRanges( 
-                static_cast<VkDevice>( memory.memory->getDevice() ), 1, reinterpret_cast<VkMappedMemoryRange*>(&range)) );
-            vk::detail::resultCheck( result, "vke::MappedDeviceMemoryResource::do_allocate" );
-        }
+        flushMappedMemory(memory);
 
         p_resource->deallocate(memory);
     }
@@ -212,6 +214,7 @@ namespace vke{
         vk::BufferCreateInfo createInfo{{}, requirements.size, vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst};
 
         deviceLocalMemory.mapped = stagingMemory.mapped;
+        deviceLocalMemory.hostCoherent = stagingMemory.hostCoherent;
         map[deviceLocalMemory.mapped] = {stagingMemory, vk::raii::Buffer{*p_device, createInfo}, vk::raii::Buffer{*p_device, createInfo} };
 
         return deviceLocalMemory;
@@ -248,4 +251,32 @@ namespace vke{
         default_device_memory_res = resource;
         return default_device_memory_res;
     }
+
+    void flushMappedMemory(const DeviceMemoryInfo& memory)
+    {
+        if(!memory.mapped || memory.hostCoherent)
+            return;
+
+        vk::MappedMemoryRange range = getMappedMemoryRange(memory);
+
+        VULKAN_HPP_ASSERT( memory.memory->getDispatcher()->vkFlushMappedMemoryRanges && "Function <vkFlushMappedMemoryRanges> requires <VK_VERSION_1_0>" );
+
+        vk::Result result = static_cast<vk::Result>( memory.memory->getDispatcher()->vkFlushMappedMemoryRanges( 
+            static_cast<VkDevice>( memory.memory->getDevice() ), 1, reinterpret_cast<VkMappedMemoryRange*>(&range)) );
+        vk::detail::resultCheck( result, "vke::flushMappedMemory" );
+    }
+
+    void invalidateMappedMemory(const DeviceMemoryInfo& memory)
+    {
+        if(!memory.mapped || memory.hostCoherent)
+            return;
+
+        vk::MappedMemoryRange range = getMappedMemoryRange(memory);
+
+        VULKAN_HPP_ASSERT( memory.memory->getDispatcher()->vkInvalidateMappedMemoryRanges && "Function <vkInvalidateMappedMemoryRanges> requires <VK_VERSION_1_0>" );
+
+        vk::Result result = static_cast<vk::Result>( memory.memory->getDispatcher()->vkInvalidateMappedMemoryRanges( 
+            static_cast<VkDevice>( memory.memory->getDevice() ), 1, reinterpret_cast<VkMappedMemoryRange*>(&range)) );
+        vk::detail::resultCheck( result, "vke::invalidateMappedMemory" );
+    }
 }
\ No newline at end of file
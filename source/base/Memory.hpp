@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Base.hpp"
+#include "Synchronization.hpp"
 
 #include <unordered_map>
 
@@ -13,6 +14,8 @@ namespace vke{
         vk::DeviceSize offset = 0;
         vk::DeviceSize size = 0;
         void* mapped = nullptr;
+        bool hostCoherent = false;
+        vk::DeviceSize nonCoherentAtomSize = 1;
     };
     
     class DeviceMemoryResource
@@ -93,6 +96,7 @@ namespace vke{
         DeviceMemoryResource* p_resource = nullptr;
         uint32_t visibleIndices = 0;
         uint32_t coherentIndices = 0;
+        vk::DeviceSize nonCoherentAtomSize = 1;
 
         DeviceMemoryInfo do_allocate(vk::MemoryRequirements requirements) override;
         void do_deallocate(DeviceMemoryInfo memory) override;
@@ -139,18 +143,38 @@ namespace vke{
     DeviceMemoryResource* getDefaultDeviceMemoryResource(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice);
     DeviceMemoryResource* setDefaultDeviceMemoryResource(DeviceMemoryResource* resource);
 
+    void flushMappedMemory(const DeviceMemoryInfo& memory);
+    void invalidateMappedMemory(const DeviceMemoryInfo& memory);
+
     template<class T>
     class DeviceMemory
     {
     public:
         explicit DeviceMemory() = default;
         DeviceMemory(DeviceMemoryInfo info, std::function<void(DeviceMemoryInfo*)> deleter) : info_{info}, deleter_{deleter} {};
-        ~DeviceMemory() { if(deleter_) { deleter_(&info_); } };
+        ~DeviceMemory() { reset(); };
 
         DeviceMemory(const DeviceMemory&) = delete;
         DeviceMemory& operator=(const DeviceMemory&) = delete;
-        DeviceMemory(DeviceMemory&&) noexcept = default;
-        DeviceMemory& operator=(DeviceMemory&&) noexcept = default;
+        DeviceMemory(DeviceMemory&& other) noexcept 
+            : info_{std::exchange(other.info_, DeviceMemoryInfo{})}, deleter_{std::exchange(other.deleter_, nullptr)} {}
+        DeviceMemory& operator=(DeviceMemory&& other) noexcept
+        {
+            if(this != &other)
+            {
+                reset();
+                info_ = std::exchange(other.info_, DeviceMemoryInfo{});
+                deleter_ = std::exchange(other.deleter_, nullptr);
+            }
+            return *this;
+        }
+
+        inline void reset()
+        {
+            if(deleter_) { deleter_(&info_); }
+            info_ = DeviceMemoryInfo{};
+            deleter_ = nullptr;
+        }
 
         inline void bind(const vk::raii::Buffer& buffer) { buffer.bindMemory(*(info_.memory), info_.offset); }
         inline void bind(const vk::raii::Image& image) { image.bindMemory(*(info_.memory), info_.offset); }
@@ -158,6 +182,9 @@ namespace vke{
         inline T* data() noexcept { return reinterpret_cast<T*>(info_.mapped); }
         inline size_t size() noexcept { return info_.size / sizeof(T) ; }
 
+        inline void flush() const { flushMappedMemory(info_); }
+        inline void invalidate() const { invalidateMappedMemory(info_); }
+
     private:
         DeviceMemoryInfo info_{};
         std::function<void(DeviceMemoryInfo*)> deleter_ = nullptr;
@@ -179,7 +206,13 @@ namespace vke{
         {
             if(!p_resource) p_resource = getDefaultDeviceMemoryResource(device, physicalDevice);
             return {p_resource->allocate(requirements), 
-                [p_resource = this->p_resource](DeviceMemoryInfo* info) { p_resource->deallocate(*info); }};
+                [p_resource = this->p_resource, p_deletionQueue = getDefaultDeletionQueue()](DeviceMemoryInfo* info) 
+                {
+                    if(p_deletionQueue)
+                        p_deletionQueue->enqueue([p_resource, info = *info]{ p_resource->deallocate(info); });
+                    else
+                        p_resource->deallocate(*info);
+                }};
         }
 
         inline operator bool() const noexcept { return p_resource; }
@@ -0,0 +1,525 @@
+#include "Pipeline.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <format>
+
+namespace vke{
+
+    namespace {
+        constexpr uint32_t pipelineCacheFileMagic = 0x564B4543;
+        constexpr uint32_t pipelineCacheFileVersion = 1;
+
+        struct PipelineCacheFileHeader
+        {
+            uint32_t magic = pipelineCacheFileMagic;
+            uint32_t version = pipelineCacheFileVersion;
+            uint32_t vendorID = 0;
+            uint32_t deviceID = 0;
+            uint32_t driverVersion = 0;
+            uint8_t pipelineCacheUUID[VK_UUID_SIZE]{};
+            uint64_t dataSize = 0;
+            uint64_t dataHash = 0;
+        };
+
+        uint64_t hashBytes(uint64_t hash, const void* data, size_t size) noexcept
+        {
+            for(const uint8_t byte : std::span{reinterpret_cast<const uint8_t*>(data), size})
+            {
+                hash = (hash ^ byte) * 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        uint64_t hashData(std::span<const uint8_t> data) noexcept
+        {
+            return hashBytes(0xcbf29ce484222325ull, data.data(), data.size());
+        }
+
+        struct StateHasher
+        {
+            uint64_t value = 0xcbf29ce484222325ull;
+            std::vector<uint8_t> key{};
+
+            inline void append(const void* data, size_t size)
+            {
+                value = hashBytes(value, data, size);
+                key.insert(key.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+            }
+
+            template<class T>
+                requires std::is_trivially_copyable_v<T>
+            inline void operator()(const T& data) { append(&data, sizeof(T)); }
+
+            template<class T>
+                requires std::is_trivially_copyable_v<T>
+            inline void operator()(std::span<const T> data) 
+            { 
+                (*this)(data.size());
+                append(data.data(), data.size_bytes()); 
+            }
+
+            inline void operator()(std::string_view data) 
+            { 
+                (*this)(data.size());
+                append(data.data(), data.size()); 
+            }
+        };
+
+        template<class T>
+        std::optional<T> copyState(const T* state)
+        {
+            if(!state)
+                return std::nullopt;
+
+            if(state->pNext)
+            {
+                throw std::runtime_error{std::format("vke::PipelineState, Unsupported pNext chain on {}", vk::to_string(state->sType))};
+            }
+
+            return *state;
+        }
+
+        template<class T>
+        std::vector<T> copyArray(const T* data, uint32_t count)
+        {
+            return data ? std::vector<T>(data, data + count) : std::vector<T>{};
+        }
+
+        bool isCompatible(const PipelineCacheFileHeader& header, const vk::PhysicalDeviceProperties& properties) noexcept
+        {
+            return header.magic == pipelineCacheFileMagic && header.version == pipelineCacheFileVersion &&
+                header.vendorID == properties.vendorID && header.deviceID == properties.deviceID && 
+                header.driverVersion == properties.driverVersion &&
+                std::ranges::equal(header.pipelineCacheUUID, properties.pipelineCacheUUID);
+        }
+    }
+
+    PipelineCache::PipelineCache(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, const CreateInfo& createInfo)
+        : p_device{&device}, properties{physicalDevice.getProperties()}, path{createInfo.path()}
+    {
+        std::vector<uint8_t> initialData = load();
+        loadedFromDisk = !initialData.empty();
+        savedDataHash = hashData(initialData);
+
+        cache = vk::raii::PipelineCache{device, vk::PipelineCacheCreateInfo{ {}, initialData.size(), initialData.data() }};
+
+        std::chrono::seconds saveInterval = createInfo.saveInterval();
+        if(!path.empty() && saveInterval.count() > 0)
+        {
+            saveThread = std::jthread{[this, saveInterval](std::stop_token stopToken)
+            {
+                std::unique_lock lock{saveMutex};
+                while(!saveCondition.wait_for(lock, stopToken, saveInterval, []{ return false; }))
+                {
+                    if(stopToken.stop_requested())
+                        break;
+
+                    lock.unlock();
+                    try
+                    {
+                        save();
+                    }
+                    catch(...) {}
+                    lock.lock();
+                }
+            }};
+        }
+    }
+
+    PipelineCache::PipelineCache(const Device& device, const CreateInfo& createInfo)
+        : PipelineCache{device, device.getPhysicalDevice(), createInfo} {}
+
+    PipelineCache::~PipelineCache()
+    {
+        if(saveThread.joinable())
+        {
+            saveThread.request_stop();
+            saveThread.join();
+        }
+
+        try
+        {
+            save();
+        }
+        catch(...) {}
+    }
+
+    const vk::raii::PipelineCache& PipelineCache::getThreadCache()
+    {
+        std::lock_guard lock{mutex};
+
+        auto it = threadCaches.find(std::this_thread::get_id());
+        if(it == threadCaches.end())
+        {
+            std::vector<uint8_t> initialData = cache.getData();
+            it = threadCaches.emplace(std::this_thread::get_id(), 
+                vk::raii::PipelineCache{*p_device, vk::PipelineCacheCreateInfo{ {}, initialData.size(), initialData.data() }}).first;
+        }
+
+        return it->second;
+    }
+
+    void PipelineCache::merge()
+    {
+        std::lock_guard lock{mutex};
+
+        if(threadCaches.empty())
+            return;
+
+        auto sourceCaches = std::ranges::to<std::vector<vk::PipelineCache>>(threadCaches 
+            | std::ranges::views::transform([](const auto& pair) -> vk::PipelineCache { return *pair.second; }));
+
+        cache.merge(sourceCaches);
+    }
+
+    void PipelineCache::save()
+    {
+        if(path.empty())
+            return;
+
+        merge();
+
+        std::vector<uint8_t> data = cache.getData();
+        uint64_t dataHash = hashData(data);
+
+        std::lock_guard lock{mutex};
+
+        if(dataHash == savedDataHash)
+            return;
+
+        PipelineCacheFileHeader header{};
+        header.vendorID = properties.vendorID;
+        header.deviceID = properties.deviceID;
+        header.driverVersion = properties.driverVersion;
+        std::ranges::copy(properties.pipelineCacheUUID, header.pipelineCacheUUID);
+        header.dataSize = data.size();
+        header.dataHash = dataHash;
+
+        if(path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path());
+
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        {
+            std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+            if(!file)
+            {
+                throw std::runtime_error{std::format("vke::PipelineCache::save, Failed to write {}", temporaryPath.string())};
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path);
+        savedDataHash = dataHash;
+    }
+
+    std::vector<uint8_t> PipelineCache::load() const
+    {
+        if(path.empty() || !std::filesystem::exists(path))
+            return {};
+
+        std::error_code error{};
+        uintmax_t fileSize = std::filesystem::file_size(path, error);
+        if(error || fileSize < sizeof(PipelineCacheFileHeader))
+            return {};
+
+        std::ifstream file{path, std::ios::binary};
+
+        PipelineCacheFileHeader header{};
+        if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || !isCompatible(header, properties))
+            return {};
+
+        if(header.dataSize != fileSize - sizeof(header))
+            return {};
+
+        std::vector<uint8_t> data(header.dataSize);
+        if(!file.read(reinterpret_cast<char*>(data.data()), data.size()) || hashData(data) != header.dataHash)
+            return {};
+
+        vk::PipelineCacheHeaderVersionOne cacheHeader{};
+        if(data.size() < sizeof(cacheHeader))
+            return {};
+
+        std::memcpy(&cacheHeader, data.data(), sizeof(cacheHeader));
+
+        if(cacheHeader.headerVersion != vk::PipelineCacheHeaderVersion::eOne ||
+            cacheHeader.vendorID != properties.vendorID || cacheHeader.deviceID != properties.deviceID ||
+            !std::ranges::equal(cacheHeader.pipelineCacheUUID, properties.pipelineCacheUUID))
+            return {};
+
+        return data;
+    }
+
+    PipelineState::PipelineState(const vk::GraphicsPipelineCreateInfo& createInfo_)
+    {
+        vk::GraphicsPipelineCreateInfo info = createInfo_;
+        info.setPNext(nullptr);
+
+        for(const auto* next = reinterpret_cast<const vk::BaseInStructure*>(createInfo_.pNext); next; next = next->pNext)
+        {
+            if(next->sType != vk::StructureType::ePipelineRenderingCreateInfo)
+            {
+                throw std::runtime_error{std::format("vke::PipelineState, Unsupported pNext chain on {}", vk::to_string(next->sType))};
+            }
+
+            const auto& rendering = *reinterpret_cast<const vk::PipelineRenderingCreateInfo*>(next);
+            colorAttachmentFormats = copyArray(rendering.pColorAttachmentFormats, rendering.colorAttachmentCount);
+            renderingInfo = vk::PipelineRenderingCreateInfo{ rendering.viewMask, colorAttachmentFormats, 
+                rendering.depthAttachmentFormat, rendering.stencilAttachmentFormat };
+            info.setPNext(&*renderingInfo);
+        }
+
+        copyStages({info.pStages, info.stageCount});
+        info.setStages(stageInfos);
+
+        if((vertexInputState = copyState(info.pVertexInputState)))
+        {
+            vertexBindings = copyArray(vertexInputState->pVertexBindingDescriptions, vertexInputState->vertexBindingDescriptionCount);
+            vertexAttributes = copyArray(vertexInputState->pVertexAttributeDescriptions, vertexInputState->vertexAttributeDescriptionCount);
+            vertexInputState->setVertexBindingDescriptions(vertexBindings);
+            vertexInputState->setVertexAttributeDescriptions(vertexAttributes);
+        }
+
+        inputAssemblyState = copyState(info.pInputAssemblyState);
+        tessellationState = copyState(info.pTessellationState);
+
+        if((dynamicState = copyState(info.pDynamicState)))
+        {
+            dynamicStates = copyArray(dynamicState->pDynamicStates, dynamicState->dynamicStateCount);
+            dynamicState->setDynamicStates(dynamicStates);
+        }
+
+        auto isDynamic = [this](vk::DynamicState state, vk::DynamicState withCount)
+        {
+            return std::ranges::find_if(dynamicStates, [&](vk::DynamicState s){ return s == state || s == withCount; }) != dynamicStates.end();
+        };
+
+        if((viewportState = copyState(info.pViewportState)))
+        {
+            // Dynamic viewports and scissors are ignored by the driver, so they must not split the cache key either.
+            if(!isDynamic(vk::DynamicState::eViewport, vk::DynamicState::eViewportWithCount))
+                viewports = copyArray(viewportState->pViewports, viewportState->viewportCount);
+            if(!isDynamic(vk::DynamicState::eScissor, vk::DynamicState::eScissorWithCount))
+                scissors = copyArray(viewportState->pScissors, viewportState->scissorCount);
+            viewportState->setPViewports(viewports.empty() ? nullptr : viewports.data());
+            viewportState->setPScissors(scissors.empty() ? nullptr : scissors.data());
+        }
+
+        rasterizationState = copyState(info.pRasterizationState);
+
+        if((multisampleState = copyState(info.pMultisampleState)))
+        {
+            sampleMask = copyArray(multisampleState->pSampleMask, (static_cast<uint32_t>(multisampleState->rasterizationSamples) + 31) / 32);
+            multisampleState->setPSampleMask(sampleMask.empty() ? nullptr : sampleMask.data());
+        }
+
+        depthStencilState = copyState(info.pDepthStencilState);
+
+        if((colorBlendState = copyState(info.pColorBlendState)))
+        {
+            colorBlendAttachments = copyArray(colorBlendState->pAttachments, colorBlendState->attachmentCount);
+            colorBlendState->setAttachments(colorBlendAttachments);
+        }
+
+        info.setPVertexInputState(vertexInputState ? &*vertexInputState : nullptr);
+        info.setPInputAssemblyState(inputAssemblyState ? &*inputAssemblyState : nullptr);
+        info.setPTessellationState(tessellationState ? &*tessellationState : nullptr);
+        info.setPViewportState(viewportState ? &*viewportState : nullptr);
+        info.setPRasterizationState(rasterizationState ? &*rasterizationState : nullptr);
+        info.setPMultisampleState(multisampleState ? &*multisampleState : nullptr);
+        info.setPDepthStencilState(depthStencilState ? &*depthStencilState : nullptr);
+        info.setPColorBlendState(colorBlendState ? &*colorBlendState : nullptr);
+        info.setPDynamicState(dynamicState ? &*dynamicState : nullptr);
+
+        StateHasher hasher{};
+        hasher(info.flags);
+
+        for(const Stage& stage : stages)
+        {
+            hasher(stage.info.flags);
+            hasher(stage.info.stage);
+            hasher(stage.info.module);
+            hasher(std::string_view{stage.entryPoint});
+            hasher(std::span<const vk::SpecializationMapEntry>{stage.mapEntries});
+            hasher(std::span<const uint8_t>{stage.data});
+        }
+
+        if(vertexInputState)
+        {
+            hasher(vertexInputState->flags);
+            hasher(std::span<const vk::VertexInputBindingDescription>{vertexBindings});
+            hasher(std::span<const vk::VertexInputAttributeDescription>{vertexAttributes});
+        }
+
+        if(inputAssemblyState)
+        {
+            hasher(inputAssemblyState->flags);
+            hasher(inputAssemblyState->topology);
+            hasher(inputAssemblyState->primitiveRestartEnable);
+        }
+
+        if(tessellationState)
+        {
+            hasher(tessellationState->flags);
+            hasher(tessellationState->patchControlPoints);
+        }
+
+        if(viewportState)
+        {
+            hasher(viewportState->flags);
+            hasher(viewportState->viewportCount);
+            hasher(viewportState->scissorCount);
+            hasher(std::span<const vk::Viewport>{viewports});
+            hasher(std::span<const vk::Rect2D>{scissors});
+        }
+
+        if(rasterizationState)
+        {
+            hasher(rasterizationState->flags);
+            hasher(rasterizationState->depthClampEnable);
+            hasher(rasterizationState->rasterizerDiscardEnable);
+            hasher(rasterizationState->polygonMode);
+            hasher(rasterizationState->cullMode);
+            hasher(rasterizationState->frontFace);
+            hasher(rasterizationState->depthBiasEnable);
+            hasher(rasterizationState->depthBiasConstantFactor);
+            hasher(rasterizationState->depthBiasClamp);
+            hasher(rasterizationState->depthBiasSlopeFactor);
+            hasher(rasterizationState->lineWidth);
+        }
+
+        if(multisampleState)
+        {
+            hasher(multisampleState->flags);
+            hasher(multisampleState->rasterizationSamples);
+            hasher(multisampleState->sampleShadingEnable);
+            hasher(multisampleState->minSampleShading);
+            hasher(std::span<const vk::SampleMask>{sampleMask});
+            hasher(multisampleState->alphaToCoverageEnable);
+            hasher(multisampleState->alphaToOneEnable);
+        }
+
+        if(depthStencilState)
+        {
+            hasher(depthStencilState->flags);
+            hasher(depthStencilState->depthTestEnable);
+            hasher(depthStencilState->depthWriteEnable);
+            hasher(depthStencilState->depthCompareOp);
+            hasher(depthStencilState->depthBoundsTestEnable);
+            hasher(depthStencilState->stencilTestEnable);
+            hasher(depthStencilState->front);
+            hasher(depthStencilState->back);
+            hasher(depthStencilState->minDepthBounds);
+            hasher(depthStencilState->maxDepthBounds);
+        }
+
+        if(colorBlendState)
+        {
+            hasher(colorBlendState->flags);
+            hasher(colorBlendState->logicOpEnable);
+            hasher(colorBlendState->logicOp);
+            hasher(std::span<const vk::PipelineColorBlendAttachmentState>{colorBlendAttachments});
+            hasher(colorBlendState->blendConstants);
+        }
+
+        if(dynamicState)
+        {
+            hasher(dynamicState->flags);
+            hasher(std::span<const vk::DynamicState>{dynamicStates});
+        }
+
+        if(renderingInfo)
+        {
+            hasher(renderingInfo->viewMask);
+            hasher(std::span<const vk::Format>{colorAttachmentFormats});
+            hasher(renderingInfo->depthAttachmentFormat);
+            hasher(renderingInfo->stencilAttachmentFormat);
+        }
+
+        hasher(info.layout);
+        hasher(info.renderPass);
+        hasher(info.subpass);
+        hasher(info.basePipelineHandle);
+        hasher(info.basePipelineIndex);
+
+        hash = hasher.value;
+        key = std::move(hasher.key);
+        createInfo = info;
+    }
+
+    PipelineState::PipelineState(const vk::ComputePipelineCreateInfo& createInfo_)
+    {
+        if(createInfo_.pNext)
+        {
+            throw std::runtime_error{"vke::PipelineState, Unsupported pNext chain on vk::ComputePipelineCreateInfo"};
+        }
+
+        vk::ComputePipelineCreateInfo info = createInfo_;
+
+        copyStages({&info.stage, 1});
+        info.setStage(stageInfos.front());
+
+        StateHasher hasher{};
+        hasher(info.flags);
+        hasher(stages.front().info.flags);
+        hasher(stages.front().info.module);
+        hasher(std::string_view{stages.front().entryPoint});
+        hasher(std::span<const vk::SpecializationMapEntry>{stages.front().mapEntries});
+        hasher(std::span<const uint8_t>{stages.front().data});
+        hasher(info.layout);
+        hasher(info.basePipelineHandle);
+        hasher(info.basePipelineIndex);
+
+        hash = hasher.value;
+        key = std::move(hasher.key);
+        createInfo = info;
+    }
+
+    vk::raii::Pipeline PipelineState::create(const vk::raii::Device& device, const vk::raii::PipelineCache* pipelineCache) const
+    {
+        return std::visit([&](const auto& info) -> vk::raii::Pipeline { return vk::raii::Pipeline{device, pipelineCache, info}; }, createInfo);
+    }
+
+    void PipelineState::copyStages(std::span<const vk::PipelineShaderStageCreateInfo> sourceStages)
+    {
+        stages.reserve(sourceStages.size());
+
+        for(const auto& source : sourceStages)
+        {
+            if(source.pNext)
+            {
+                throw std::runtime_error{"vke::PipelineState, Unsupported pNext chain on vk::PipelineShaderStageCreateInfo"};
+            }
+
+            Stage& stage = stages.emplace_back(Stage{ .info = source, .entryPoint = source.pName ? source.pName : "main" });
+
+            if(source.pSpecializationInfo)
+            {
+                stage.mapEntries = copyArray(source.pSpecializationInfo->pMapEntries, source.pSpecializationInfo->mapEntryCount);
+                stage.data = copyArray(reinterpret_cast<const uint8_t*>(source.pSpecializationInfo->pData), 
+                    static_cast<uint32_t>(source.pSpecializationInfo->dataSize));
+            }
+        }
+
+        stageInfos.reserve(stages.size());
+
+        for(Stage& stage : stages)
+        {
+            stage.info.setPName(stage.entryPoint.c_str());
+
+            if(stage.info.pSpecializationInfo)
+            {
+                stage.specializationInfo.setMapEntries(stage.mapEntries);
+                stage.specializationInfo.setDataSize(stage.data.size());
+                stage.specializationInfo.setPData(stage.data.data());
+                stage.info.setPSpecializationInfo(&stage.specializationInfo);
+            }
+
+            stageInfos.emplace_back(stage.info);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+
+namespace vke{
+
+    class PipelineCache
+    {
+    public:
+        struct CreateInfo
+        {
+            Getter<std::filesystem::path> path{ std::filesystem::path{} };
+            Getter<std::chrono::seconds> saveInterval{ std::chrono::seconds{0} };
+        };
+
+        PipelineCache(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, const CreateInfo& createInfo);
+        PipelineCache(const Device& device, const CreateInfo& createInfo);
+        ~PipelineCache();
+
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+
+        const vk::raii::PipelineCache& getThreadCache();
+        void merge();
+        void save();
+
+        inline bool isWarm() const noexcept { return loadedFromDisk; }
+
+        inline operator const vk::raii::PipelineCache & () const & noexcept { return cache; }
+        inline operator vk::PipelineCache () const & noexcept { return *cache; }
+        inline const auto* operator->() const & noexcept { return &cache; }
+
+    private:
+        const vk::raii::Device* p_device = nullptr;
+        vk::PhysicalDeviceProperties properties{};
+        std::filesystem::path path{};
+        vk::raii::PipelineCache cache{ nullptr };
+        bool loadedFromDisk = false;
+
+        std::mutex mutex;
+        std::unordered_map<std::thread::id, vk::raii::PipelineCache> threadCaches;
+        uint64_t savedDataHash = 0;
+
+        std::mutex saveMutex;
+        std::condition_variable_any saveCondition;
+        std::jthread saveThread;
+
+        std::vector<uint8_t> load() const;
+    };
+
+    class PipelineState
+    {
+    public:
+        explicit PipelineState(const vk::GraphicsPipelineCreateInfo& createInfo);
+        explicit PipelineState(const vk::ComputePipelineCreateInfo& createInfo);
+
+        PipelineState(const PipelineState&) = delete;
+        PipelineState& operator=(const PipelineState&) = delete;
+
+        inline bool isCompute() const noexcept { return std::holds_alternative<vk::ComputePipelineCreateInfo>(createInfo); }
+        inline uint64_t getHash() const noexcept { return hash; }
+
+        inline bool operator==(const PipelineState& other) const noexcept { return hash == other.hash && key == other.key; }
+
+        vk::raii::Pipeline create(const vk::raii::Device& device, const vk::raii::PipelineCache* pipelineCache = nullptr) const;
+
+    private:
+        struct Stage
+        {
+            vk::PipelineShaderStageCreateInfo info{};
+            std::string entryPoint{};
+            vk::SpecializationInfo specializationInfo{};
+            std::vector<vk::SpecializationMapEntry> mapEntries{};
+            std::vector<uint8_t> data{};
+        };
+
+        std::variant<vk::GraphicsPipelineCreateInfo, vk::ComputePipelineCreateInfo> createInfo;
+        uint64_t hash = 0;
+        std::vector<uint8_t> key;
+
+        std::vector<Stage> stages;
+        std::vector<vk::PipelineShaderStageCreateInfo> stageInfos;
+
+        std::vector<vk::VertexInputBindingDescription> vertexBindings;
+        std::vector<vk::VertexInputAttributeDescription> vertexAttributes;
+        std::vector<vk::Viewport> viewports;
+        std::vector<vk::Rect2D> scissors;
+        std::vector<vk::SampleMask> sampleMask;
+        std::vector<vk::PipelineColorBlendAttachmentState> colorBlendAttachments;
+        std::vector<vk::DynamicState> dynamicStates;
+        std::vector<vk::Format> colorAttachmentFormats;
+
+        std::optional<vk::PipelineVertexInputStateCreateInfo> vertexInputState;
+        std::optional<vk::PipelineInputAssemblyStateCreateInfo> inputAssemblyState;
+        std::optional<vk::PipelineTessellationStateCreateInfo> tessellationState;
+        std::optional<vk::PipelineViewportStateCreateInfo> viewportState;
+        std::optional<vk::PipelineRasterizationStateCreateInfo> rasterizationState;
+        std::optional<vk::PipelineMultisampleStateCreateInfo> multisampleState;
+        std::optional<vk::PipelineDepthStencilStateCreateInfo> depthStencilState;
+        std::optional<vk::PipelineColorBlendStateCreateInfo> colorBlendState;
+        std::optional<vk::PipelineDynamicStateCreateInfo> dynamicState;
+        std::optional<vk::PipelineRenderingCreateInfo> renderingInfo;
+
+        void copyStages(std::span<const vk::PipelineShaderStageCreateInfo> sourceStages);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "Profiler.hpp"
+
+#include <array>
+#include <format>
+
+namespace vke{
+    namespace{
+        constexpr uint64_t calibration_interval = 64;
+    }
+
+    GpuProfiler::GpuProfiler(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, const CreateInfo& createInfo)
+        : p_device{&device}, timestampPeriod{physicalDevice.getProperties().limits.timestampPeriod},
+        framesInFlight{std::max(createInfo.framesInFlight, 1u)}, maxQueriesPerFrame{std::max(createInfo.maxZonesPerFrame, 1u) * 2},
+        maxResolvedZones{createInfo.maxResolvedZones}, processId{createInfo.processId}, threadId{createInfo.threadId}
+    {
+        queryPool = vk::raii::QueryPool{ device, vk::QueryPoolCreateInfo{ {}, vk::QueryType::eTimestamp, framesInFlight * maxQueriesPerFrame } };
+        frames.resize(framesInFlight);
+
+#if defined(__linux__)
+        if(device.getDispatcher()->vkGetCalibratedTimestampsEXT)
+        {
+            auto timeDomains = physicalDevice.getCalibrateableTimeDomainsEXT();
+            calibrationSupported = std::ranges::contains(timeDomains, vk::TimeDomainEXT::eDevice) && 
+                std::ranges::contains(timeDomains, vk::TimeDomainEXT::eClockMonotonic);
+        }
+#endif
+
+        calibrate();
+    }
+
+    GpuProfiler::GpuProfiler(const Device& device, const CreateInfo& createInfo)
+        : GpuProfiler{device, device.getPhysicalDevice(), createInfo} {}
+
+    void GpuProfiler::beginFrame(const vk::raii::CommandBuffer& commandBuffer)
+    {
+        if(frameNumber % calibration_interval == calibration_interval - 1)
+            calibrate();
+
+        std::lock_guard lock{mutex};
+
+        uint32_t slotIndex = static_cast<uint32_t>(frameNumber % framesInFlight);
+        FrameSlot& frame = frames[slotIndex];
+        resolve(frame);
+
+        commandBuffer.resetQueryPool(*queryPool, slotIndex * maxQueriesPerFrame, maxQueriesPerFrame);
+
+        frame.frameNumber = frameNumber++;
+        frame.cpuBegin = getTraceTime();
+        frame.queryCount = 0;
+        frame.zones.clear();
+    }
+
+    GpuProfiler::Zone GpuProfiler::zone(const vk::raii::CommandBuffer& commandBuffer, std::string_view name)
+    {
+        uint32_t queryIndex = beginZone(commandBuffer, name);
+        return Zone{ queryIndex == UINT32_MAX ? nullptr : this, commandBuffer, queryIndex };
+    }
+
+    uint32_t GpuProfiler::beginZone(const vk::raii::CommandBuffer& commandBuffer, std::string_view name)
+    {
+        uint32_t queryIndex = UINT32_MAX;
+        {
+            std::lock_guard lock{mutex};
+            if(frameNumber == 0)
+                return UINT32_MAX;
+
+            uint32_t slotIndex = static_cast<uint32_t>((frameNumber - 1) % framesInFlight);
+            FrameSlot& frame = frames[slotIndex];
+            if(frame.queryCount + 2 > maxQueriesPerFrame)
+                return UINT32_MAX;
+
+            queryIndex = slotIndex * maxQueriesPerFrame + frame.queryCount;
+            frame.queryCount += 2;
+            frame.zones.emplace_back(std::string{name}, queryIndex, UINT32_MAX);
+        }
+
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *queryPool, queryIndex);
+        return queryIndex;
+    }
+
+    void GpuProfiler::endZone(const vk::raii::CommandBuffer& commandBuffer, uint32_t queryIndex)
+    {
+        if(queryIndex == UINT32_MAX)
+            return;
+
+        {
+            std::lock_guard lock{mutex};
+            FrameSlot& frame = frames[queryIndex / maxQueriesPerFrame];
+            auto it = std::ranges::find(frame.zones, queryIndex, &PendingZone::beginQuery);
+            if(it == frame.zones.end())
+                return;
+            it->endQuery = queryIndex + 1;
+        }
+
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, *queryPool, queryIndex + 1);
+    }
+
+    void GpuProfiler::calibrate()
+    {
+        if(!calibrationSupported)
+            return;
+
+        std::array<vk::CalibratedTimestampInfoEXT, 2> timestampInfos{ 
+            vk::CalibratedTimestampInfoEXT{ vk::TimeDomainEXT::eDevice }, 
+            vk::CalibratedTimestampInfoEXT{ vk::TimeDomainEXT::eClockMonotonic } };
+        auto [timestamps, maxDeviation] = p_device->getCalibratedTimestampsEXT(timestampInfos);
+
+        std::lock_guard lock{mutex};
+        gpuToCpuOffset = static_cast<int64_t>(timestamps[1]) - static_cast<int64_t>(static_cast<double>(timestamps[0]) * timestampPeriod);
+        calibrated = true;
+    }
+
+    std::vector<TraceEvent> GpuProfiler::getZones() const
+    {
+        std::lock_guard lock{mutex};
+        return std::vector<TraceEvent>{ resolvedZones.begin(), resolvedZones.end() };
+    }
+
+    std::vector<GpuProfiler::Frame> GpuProfiler::getFrames() const
+    {
+        std::lock_guard lock{mutex};
+        return std::vector<Frame>{ resolvedFrames.begin(), resolvedFrames.end() };
+    }
+
+    void GpuProfiler::clear()
+    {
+        std::lock_guard lock{mutex};
+        resolvedZones.clear();
+        resolvedFrames.clear();
+    }
+
+    void GpuProfiler::writeChromeTrace(std::ostream& stream, std::span<const TraceEvent> cpuEvents) const
+    {
+        std::vector<TraceEvent> events{ cpuEvents.begin(), cpuEvents.end() };
+        std::ranges::move(getZones(), std::back_inserter(events));
+        vke::writeChromeTrace(stream, events);
+    }
+
+    void GpuProfiler::resolve(FrameSlot& frame)
+    {
+        if(frame.zones.empty())
+            return;
+
+        uint32_t firstQuery = frame.zones.front().beginQuery;
+        auto [result, data] = queryPool.getResults<uint64_t>(firstQuery, frame.queryCount, 
+            frame.queryCount * 2 * sizeof(uint64_t), 2 * sizeof(uint64_t), vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+
+        auto isAvailable = [&](uint32_t query){ return data[(query - firstQuery) * 2 + 1] != 0; };
+        auto getTimestamp = [&](uint32_t query){ return data[(query - firstQuery) * 2]; };
+
+        bool complete = std::ranges::all_of(frame.zones, [&](const PendingZone& zone)
+        {
+            return zone.endQuery != UINT32_MAX && isAvailable(zone.beginQuery) && isAvailable(zone.endQuery);
+        });
+
+        if(!complete)
+        {
+            ++droppedFrameCount;
+            return;
+        }
+
+        int64_t offset = gpuToCpuOffset;
+        if(!calibrated)
+        {
+            uint64_t earliest = std::ranges::min(frame.zones | std::ranges::views::transform([&](const PendingZone& zone){ return getTimestamp(zone.beginQuery); }));
+            offset = frame.cpuBegin - toCpuTime(earliest, 0);
+        }
+
+        Frame resolvedFrame{ frame.frameNumber, INT64_MAX, INT64_MIN };
+        for(const PendingZone& zone : frame.zones)
+        {
+            TraceEvent event{ zone.name, processId, threadId, 
+                toCpuTime(getTimestamp(zone.beginQuery), offset), toCpuTime(getTimestamp(zone.endQuery), offset) };
+
+            resolvedFrame.begin = std::min(resolvedFrame.begin, event.begin);
+            resolvedFrame.end = std::max(resolvedFrame.end, event.end);
+            resolvedZones.push_back(std::move(event));
+        }
+        resolvedFrames.push_back(resolvedFrame);
+
+        while(resolvedZones.size() > maxResolvedZones)
+        {
+            resolvedZones.pop_front();
+        }
+        while(resolvedFrames.size() > maxResolvedZones)
+        {
+            resolvedFrames.pop_front();
+        }
+    }
+
+    int64_t GpuProfiler::toCpuTime(uint64_t timestamp, int64_t offset) const noexcept
+    {
+        return static_cast<int64_t>(static_cast<double>(timestamp) * timestampPeriod) + offset;
+    }
+}
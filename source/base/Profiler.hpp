@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Base.hpp"
+#include "Trace.hpp"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <string>
+
+namespace vke{
+
+    class GpuProfiler
+    {
+    public:
+        struct CreateInfo
+        {
+            uint32_t framesInFlight = 3;
+            uint32_t maxZonesPerFrame = 1024;
+            size_t maxResolvedZones = 1 << 16;
+            uint32_t processId = 1;
+            uint32_t threadId = 0;
+        };
+
+        struct Frame
+        {
+            uint64_t frameNumber = 0;
+            int64_t begin = 0;
+            int64_t end = 0;
+        };
+
+        class Zone
+        {
+        public:
+            Zone(GpuProfiler* profiler, const vk::raii::CommandBuffer& commandBuffer, uint32_t queryIndex) noexcept 
+                : p_profiler{profiler}, p_commandBuffer{&commandBuffer}, queryIndex{queryIndex} {}
+            ~Zone() { if(p_profiler) p_profiler->endZone(*p_commandBuffer, queryIndex); }
+
+            Zone(const Zone&) = delete;
+            Zone& operator=(const Zone&) = delete;
+
+        private:
+            GpuProfiler* p_profiler = nullptr;
+            const vk::raii::CommandBuffer* p_commandBuffer = nullptr;
+            uint32_t queryIndex = 0;
+        };
+
+        GpuProfiler(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, const CreateInfo& createInfo);
+        GpuProfiler(const Device& device, const CreateInfo& createInfo);
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        void beginFrame(const vk::raii::CommandBuffer& commandBuffer);
+
+        [[nodiscard]] Zone zone(const vk::raii::CommandBuffer& commandBuffer, std::string_view name);
+        uint32_t beginZone(const vk::raii::CommandBuffer& commandBuffer, std::string_view name);
+        void endZone(const vk::raii::CommandBuffer& commandBuffer, uint32_t queryIndex);
+
+        void calibrate();
+
+        std::vector<TraceEvent> getZones() const;
+        std::vector<Frame> getFrames() const;
+        void clear();
+        void writeChromeTrace(std::ostream& stream, std::span<const TraceEvent> cpuEvents = {}) const;
+
+        inline bool isCalibrated() const noexcept { return calibrated; }
+        inline uint64_t getDroppedFrameCount() const noexcept { return droppedFrameCount; }
+
+    private:
+        struct PendingZone
+        {
+            std::string name;
+            uint32_t beginQuery = 0;
+            uint32_t endQuery = UINT32_MAX;
+        };
+
+        struct FrameSlot
+        {
+            uint64_t frameNumber = 0;
+            int64_t cpuBegin = 0;
+            uint32_t queryCount = 0;
+            std::vector<PendingZone> zones;
+        };
+
+        const vk::raii::Device* p_device = nullptr;
+        vk::raii::QueryPool queryPool{ nullptr };
+        double timestampPeriod = 1.0;
+        uint32_t framesInFlight = 0;
+        uint32_t maxQueriesPerFrame = 0;
+        size_t maxResolvedZones = 0;
+        uint32_t processId = 0;
+        uint32_t threadId = 0;
+        bool calibrationSupported = false;
+
+        mutable std::mutex mutex;
+        uint64_t frameNumber = 0;
+        std::vector<FrameSlot> frames;
+        bool calibrated = false;
+        int64_t gpuToCpuOffset = 0;
+        uint64_t droppedFrameCount = 0;
+        std::deque<TraceEvent> resolvedZones;
+        std::deque<Frame> resolvedFrames;
+
+        void resolve(FrameSlot& frame);
+        int64_t toCpuTime(uint64_t timestamp, int64_t offset) const noexcept;
+    };
+
+}
@@ -0,0 +1,181 @@
+#include "Query.hpp"
+
+#include <bit>
+
+namespace vke{
+    QueryManager::QueryManager(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, const CreateInfo& createInfo)
+        : memoryResource{device, physicalDevice}, mappedMemory{physicalDevice, &memoryResource}, 
+        timestampPeriod{physicalDevice.getProperties().limits.timestampPeriod}, framesInFlight{std::max(createInfo.framesInFlight, 1u)}
+    {
+        createPool(device, physicalDevice, QueryType::eTimestamp, vk::QueryType::eTimestamp, createInfo.maxTimestampsPerFrame);
+        createPool(device, physicalDevice, QueryType::eOcclusion, vk::QueryType::eOcclusion, createInfo.maxOcclusionQueriesPerFrame);
+        if(createInfo.pipelineStatistics)
+            createPool(device, physicalDevice, QueryType::ePipelineStatistics, vk::QueryType::ePipelineStatistics, 
+                createInfo.maxPipelineStatisticsQueriesPerFrame, createInfo.pipelineStatistics);
+    }
+
+    QueryManager::QueryManager(const Device& device, const CreateInfo& createInfo)
+        : QueryManager{device, device.getPhysicalDevice(), createInfo} {}
+
+    void QueryManager::beginFrame(const vk::raii::CommandBuffer& commandBuffer)
+    {
+        std::lock_guard lock{mutex};
+
+        frameNumber++;
+        uint32_t slotIndex = getSlotIndex();
+        if(frameNumber > framesInFlight)
+            resolve(slotIndex, frameNumber - framesInFlight);
+
+        for(Pool& pool : pools)
+        {
+            if(!*pool.queryPool)
+                continue;
+
+            commandBuffer.resetQueryPool(*pool.queryPool, slotIndex * pool.maxQueriesPerFrame, pool.maxQueriesPerFrame);
+            pool.queryCounts[slotIndex] = 0;
+        }
+    }
+
+    void QueryManager::endFrame(const vk::raii::CommandBuffer& commandBuffer)
+    {
+        std::lock_guard lock{mutex};
+        if(frameNumber == 0)
+            return;
+
+        uint32_t slotIndex = getSlotIndex();
+        bool copied = false;
+
+        for(Pool& pool : pools)
+        {
+            uint32_t queryCount = *pool.queryPool ? pool.queryCounts[slotIndex] : 0;
+            if(queryCount == 0)
+                continue;
+
+            vk::DeviceSize queryStride = (pool.stride + 1) * sizeof(uint64_t);
+            commandBuffer.copyQueryPoolResults(*pool.queryPool, slotIndex * pool.maxQueriesPerFrame, queryCount, **pool.results, 
+                slotIndex * pool.maxQueriesPerFrame * queryStride, queryStride, 
+                vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability);
+            copied = true;
+        }
+
+        if(copied)
+        {
+            vk::MemoryBarrier barrier{ vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead };
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, barrier, {}, {});
+        }
+    }
+
+    uint32_t QueryManager::allocate(QueryType type, uint32_t count)
+    {
+        std::lock_guard lock{mutex};
+        Pool& pool = pools[static_cast<size_t>(type)];
+        if(frameNumber == 0 || !*pool.queryPool)
+            return UINT32_MAX;
+
+        uint32_t& queryCount = pool.queryCounts[getSlotIndex()];
+        if(queryCount + count > pool.maxQueriesPerFrame)
+            return UINT32_MAX;
+
+        uint32_t query = queryCount;
+        queryCount += count;
+        return query;
+    }
+
+    uint32_t QueryManager::beginQuery(const vk::raii::CommandBuffer& commandBuffer, QueryType type, vk::QueryControlFlags flags)
+    {
+        uint32_t query = allocate(type);
+        if(query == UINT32_MAX)
+            return UINT32_MAX;
+
+        const Pool& pool = pools[static_cast<size_t>(type)];
+        commandBuffer.beginQuery(*pool.queryPool, getSlotIndex() * pool.maxQueriesPerFrame + query, flags);
+        return query;
+    }
+
+    void QueryManager::endQuery(const vk::raii::CommandBuffer& commandBuffer, QueryType type, uint32_t query)
+    {
+        if(query == UINT32_MAX)
+            return;
+
+        const Pool& pool = pools[static_cast<size_t>(type)];
+        commandBuffer.endQuery(*pool.queryPool, getSlotIndex() * pool.maxQueriesPerFrame + query);
+    }
+
+    uint32_t QueryManager::writeTimestamp(const vk::raii::CommandBuffer& commandBuffer, vk::PipelineStageFlagBits stage)
+    {
+        uint32_t query = allocate(QueryType::eTimestamp);
+        if(query == UINT32_MAX)
+            return UINT32_MAX;
+
+        const Pool& pool = pools[static_cast<size_t>(QueryType::eTimestamp)];
+        commandBuffer.writeTimestamp(stage, *pool.queryPool, getSlotIndex() * pool.maxQueriesPerFrame + query);
+        return query;
+    }
+
+    std::optional<uint64_t> QueryManager::getValue(QueryType type, uint32_t query, uint32_t statistic) const
+    {
+        std::lock_guard lock{mutex};
+        size_t typeIndex = static_cast<size_t>(type);
+        uint32_t stride = pools[typeIndex].stride;
+
+        if(query >= results.available[typeIndex].size() || statistic >= stride || !results.available[typeIndex][query])
+            return std::nullopt;
+        return results.values[typeIndex][query * stride + statistic];
+    }
+
+    QueryManager::Results QueryManager::getResults() const
+    {
+        std::lock_guard lock{mutex};
+        return results;
+    }
+
+    void QueryManager::createPool(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, QueryType type, 
+        vk::QueryType nativeType, uint32_t maxQueriesPerFrame, vk::QueryPipelineStatisticFlags pipelineStatistics)
+    {
+        if(maxQueriesPerFrame == 0)
+            return;
+
+        Pool& pool = pools[static_cast<size_t>(type)];
+        pool.maxQueriesPerFrame = maxQueriesPerFrame;
+        pool.stride = pipelineStatistics ? static_cast<uint32_t>(std::popcount(static_cast<VkQueryPipelineStatisticFlags>(pipelineStatistics))) : 1;
+        pool.queryCounts.resize(framesInFlight);
+        pool.queryPool = vk::raii::QueryPool{ device, vk::QueryPoolCreateInfo{ {}, nativeType, framesInFlight * maxQueriesPerFrame, pipelineStatistics } };
+
+        pool.results.emplace(device, physicalDevice, BufferWrapper::CreateInfo{
+            .size = framesInFlight * maxQueriesPerFrame * (pool.stride + 1) * sizeof(uint64_t),
+            .usage = vk::BufferUsageFlags{vk::BufferUsageFlagBits::eTransferDst} }, DeviceMemoryAllocator<uint64_t>{mappedMemory});
+        std::ranges::fill(std::span{pool.results->data(), pool.results->size()}, 0);
+        pool.results->flush();
+    }
+
+    void QueryManager::resolve(uint32_t slotIndex, uint64_t slotFrameNumber)
+    {
+        results.frameNumber = slotFrameNumber;
+
+        for(auto [typeIndex, pool] : pools | std::views::enumerate)
+        {
+            auto& values = results.values[typeIndex];
+            auto& available = results.available[typeIndex];
+            values.clear();
+            available.clear();
+
+            uint32_t queryCount = *pool.queryPool ? pool.queryCounts[slotIndex] : 0;
+            if(queryCount == 0)
+                continue;
+
+            pool.results->invalidate();
+            uint64_t* data = pool.results->data() + slotIndex * pool.maxQueriesPerFrame * (pool.stride + 1);
+            for(uint32_t query = 0; query < queryCount; query++)
+            {
+                uint64_t* record = data + query * (pool.stride + 1);
+                bool isAvailable = record[pool.stride] != 0;
+
+                values.insert(values.end(), record, record + pool.stride);
+                available.push_back(isAvailable);
+                unavailableCount += isAvailable ? 0 : 1;
+                std::fill(record, record + pool.stride + 1, 0);
+            }
+            pool.results->flush();
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Base.hpp"
+#include "Memory.hpp"
+#include "Resources.hpp"
+
+#include <array>
+#include <mutex>
+#include <optional>
+
+namespace vke{
+
+    class QueryManager
+    {
+    public:
+        enum class QueryType : uint8_t
+        {
+            eTimestamp,
+            eOcclusion,
+            ePipelineStatistics,
+            eCount
+        };
+
+        struct CreateInfo
+        {
+            uint32_t framesInFlight = 3;
+            uint32_t maxTimestampsPerFrame = 1024;
+            uint32_t maxOcclusionQueriesPerFrame = 1024;
+            uint32_t maxPipelineStatisticsQueriesPerFrame = 256;
+            vk::QueryPipelineStatisticFlags pipelineStatistics{};
+        };
+
+        struct Results
+        {
+            uint64_t frameNumber = 0;
+            std::array<std::vector<uint64_t>, static_cast<size_t>(QueryType::eCount)> values;
+            std::array<std::vector<uint8_t>, static_cast<size_t>(QueryType::eCount)> available;
+        };
+
+        QueryManager(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, const CreateInfo& createInfo);
+        QueryManager(const Device& device, const CreateInfo& createInfo);
+
+        QueryManager(const QueryManager&) = delete;
+        QueryManager& operator=(const QueryManager&) = delete;
+
+        void beginFrame(const vk::raii::CommandBuffer& commandBuffer);
+        void endFrame(const vk::raii::CommandBuffer& commandBuffer);
+
+        uint32_t allocate(QueryType type, uint32_t count = 1);
+        uint32_t beginQuery(const vk::raii::CommandBuffer& commandBuffer, QueryType type, vk::QueryControlFlags flags = {});
+        void endQuery(const vk::raii::CommandBuffer& commandBuffer, QueryType type, uint32_t query);
+        uint32_t writeTimestamp(const vk::raii::CommandBuffer& commandBuffer, vk::PipelineStageFlagBits stage = vk::PipelineStageFlagBits::eBottomOfPipe);
+
+        std::optional<uint64_t> getValue(QueryType type, uint32_t query, uint32_t statistic = 0) const;
+        Results getResults() const;
+
+        inline uint32_t getStride(QueryType type) const noexcept { return pools[static_cast<size_t>(type)].stride; }
+        inline double getTimestampPeriod() const noexcept { return timestampPeriod; }
+        inline uint64_t getUnavailableCount() const noexcept { std::lock_guard lock{mutex}; return unavailableCount; }
+
+    private:
+        struct Pool
+        {
+            vk::raii::QueryPool queryPool{ nullptr };
+            std::optional<Buffer<uint64_t>> results;
+            uint32_t maxQueriesPerFrame = 0;
+            uint32_t stride = 1;
+            std::vector<uint32_t> queryCounts;
+        };
+
+        NewDeleteDeviceMemoryResource memoryResource;
+        MappedDeviceMemoryResource mappedMemory;
+        double timestampPeriod = 1.0;
+        uint32_t framesInFlight = 0;
+
+        mutable std::mutex mutex;
+        std::array<Pool, static_cast<size_t>(QueryType::eCount)> pools;
+        uint64_t frameNumber = 0;
+        uint64_t unavailableCount = 0;
+        Results results;
+
+        void createPool(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, QueryType type, 
+            vk::QueryType nativeType, uint32_t maxQueriesPerFrame, vk::QueryPipelineStatisticFlags pipelineStatistics = {});
+        void resolve(uint32_t slotIndex, uint64_t slotFrameNumber);
+        inline uint32_t getSlotIndex() const noexcept { return static_cast<uint32_t>((frameNumber - 1) % framesInFlight); }
+    };
+
+}
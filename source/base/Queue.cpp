@@ -0,0 +1,335 @@
+#include "Queue.hpp"
+#include "Instrumentation.hpp"
+
+#include <bit>
+
+namespace vke{
+
+    QueueOrchestrator::QueueOrchestrator(const Device& device)
+        : p_device{&static_cast<const vk::raii::Device&>(device)}
+    {
+        if(!device.getEnabledFeatures().synchronization2 || !device.getEnabledFeatures().timelineSemaphore)
+            throw std::runtime_error("vke::QueueOrchestrator requires the synchronization2 and timelineSemaphore features");
+
+        auto queueFamilyProperties = device.getPhysicalDevice().getQueueFamilyProperties();
+        std::vector<uint32_t> usedQueueCounts(queueFamilyProperties.size(), 0);
+
+        auto findQueue = [&](const std::function<bool(vk::QueueFlags)>& predicate) -> const DeviceQueue*
+        {
+            for(const auto& [queueFamilyIndex, properties] : queueFamilyProperties | std::views::enumerate)
+            {
+                auto queues = device.getDeviceQueues(static_cast<uint32_t>(queueFamilyIndex));
+                if(!queues.empty() && predicate(properties.queueFlags))
+                {
+                    uint32_t& usedCount = usedQueueCounts[queueFamilyIndex];
+                    return &queues[std::min<size_t>(usedCount++, queues.size() - 1)];
+                }
+            }
+            return nullptr;
+        };
+
+        const DeviceQueue* graphicsQueue = findQueue([](vk::QueueFlags flags){ return static_cast<bool>(flags & vk::QueueFlagBits::eGraphics); });
+        if(!graphicsQueue)
+            throw std::runtime_error("vke::QueueOrchestrator requires a graphics queue");
+
+        const DeviceQueue* computeQueue = findQueue([](vk::QueueFlags flags)
+            { return (flags & vk::QueueFlagBits::eCompute) && !(flags & vk::QueueFlagBits::eGraphics); });
+        bool dedicatedCompute = computeQueue != nullptr;
+        if(!computeQueue)
+            computeQueue = findQueue([](vk::QueueFlags flags){ return static_cast<bool>(flags & vk::QueueFlagBits::eCompute); });
+
+        const DeviceQueue* transferQueue = findQueue([](vk::QueueFlags flags)
+            { return (flags & vk::QueueFlagBits::eTransfer) && !(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute)); });
+        bool dedicatedTransfer = transferQueue != nullptr;
+        if(!transferQueue)
+            transferQueue = dedicatedCompute ? computeQueue : graphicsQueue;
+
+        std::array<std::pair<const DeviceQueue*, bool>, 3> laneQueues{ 
+            std::pair{graphicsQueue, true}, 
+            std::pair{computeQueue ? computeQueue : graphicsQueue, dedicatedCompute}, 
+            std::pair{transferQueue, dedicatedTransfer} };
+
+        for(const auto& [index, laneQueue] : laneQueues | std::views::enumerate)
+        {
+            auto& lane = lanes[index];
+            lane = std::make_unique<LaneState>();
+            lane->p_queue = laneQueue.first;
+            lane->dedicated = laneQueue.second;
+            lane->semaphore.emplace(*p_device);
+            lane->commandPool = vk::raii::CommandPool{ *p_device, vk::CommandPoolCreateInfo{ 
+                vk::CommandPoolCreateFlagBits::eResetCommandBuffer | vk::CommandPoolCreateFlagBits::eTransient, laneQueue.first->getQueueFamilyIndex() } };
+        }
+    }
+
+    std::vector<std::vector<DeviceQueueInfo>> QueueOrchestrator::addDedicatedQueueInfos(const vk::raii::PhysicalDevice& physicalDevice, 
+        std::vector<std::vector<DeviceQueueInfo>> deviceQueueInfos, uint32_t queueUsageFlags, float queuePriority)
+    {
+        auto queueFamilyProperties = physicalDevice.getQueueFamilyProperties();
+        if(deviceQueueInfos.size() < queueFamilyProperties.size())
+            deviceQueueInfos.resize(queueFamilyProperties.size());
+
+        auto addQueue = [&](vk::QueueFlags required, vk::QueueFlags excluded)
+        {
+            for(const auto& [queueFamilyIndex, properties] : queueFamilyProperties | std::views::enumerate)
+            {
+                if((properties.queueFlags & required) == required && !(properties.queueFlags & excluded))
+                {
+                    if(deviceQueueInfos[queueFamilyIndex].empty())
+                        deviceQueueInfos[queueFamilyIndex].emplace_back(queueUsageFlags, queuePriority);
+                    return;
+                }
+            }
+        };
+
+        addQueue(vk::QueueFlagBits::eCompute, vk::QueueFlagBits::eGraphics);
+        addQueue(vk::QueueFlagBits::eTransfer, vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute);
+
+        return deviceQueueInfos;
+    }
+
+    QueueOrchestrator::Ticket QueueOrchestrator::submit(Lane laneIndex, const RecordFunction& recordFunction, std::span<const Ticket> waits)
+    {
+        VKE_ZONE("QueueOrchestrator::submit");
+        LaneState& lane = getLane(laneIndex);
+        std::lock_guard lock{lane.mutex};
+
+        uint64_t completedValue = lane.semaphore->getValue();
+        while(!lane.inFlight.empty() && lane.inFlight.front().first <= completedValue)
+        {
+            lane.freeCommandBuffers.push_back(std::move(lane.inFlight.front().second));
+            lane.inFlight.pop_front();
+        }
+
+        vk::raii::CommandBuffer commandBuffer{ nullptr };
+        if(!lane.freeCommandBuffers.empty())
+        {
+            commandBuffer = std::move(lane.freeCommandBuffers.back());
+            lane.freeCommandBuffers.pop_back();
+        }
+        else
+        {
+            commandBuffer = std::move(vk::raii::CommandBuffers{ *p_device, 
+                vk::CommandBufferAllocateInfo{ *lane.commandPool, vk::CommandBufferLevel::ePrimary, 1 } }.front());
+        }
+
+        commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+        recordFunction(commandBuffer);
+        commandBuffer.end();
+
+        std::vector<vk::SemaphoreSubmitInfo> waitInfos{};
+        for(const Ticket& wait : waits)
+        {
+            if(wait.value != 0)
+                waitInfos.emplace_back(*getLane(wait.lane).semaphore, wait.value, vk::PipelineStageFlagBits2::eAllCommands);
+        }
+
+        uint64_t value = lane.submittedValue + 1;
+        vk::SemaphoreSubmitInfo signalInfo{ *lane.semaphore, value, vk::PipelineStageFlagBits2::eAllCommands };
+        vk::CommandBufferSubmitInfo commandBufferInfo{ *commandBuffer };
+
+        vk::SubmitInfo2 submitInfo{};
+        submitInfo.setWaitSemaphoreInfos(waitInfos)
+            .setCommandBufferInfos(commandBufferInfo)
+            .setSignalSemaphoreInfos(signalInfo);
+
+        lane.p_queue->submit2(submitInfo);
+
+        lane.submittedValue = value;
+        lane.inFlight.emplace_back(value, std::move(commandBuffer));
+
+        return Ticket{ laneIndex, value };
+    }
+
+    QueueOrchestrator::Ticket QueueOrchestrator::dispatch(const RecordFunction& recordFunction, std::span<const Ticket> waits)
+    {
+        return submit(Lane::eCompute, recordFunction, waits);
+    }
+
+    QueueOrchestrator::Ticket QueueOrchestrator::upload(const RecordFunction& recordFunction, std::span<const BufferTransfer> buffers, 
+        std::span<const ImageTransfer> images, Lane destination)
+    {
+        return transferOwnership(submit(Lane::eTransfer, recordFunction), destination, buffers, images);
+    }
+
+    QueueOrchestrator::Ticket QueueOrchestrator::transferOwnership(Ticket after, Lane destination, 
+        std::span<const BufferTransfer> buffers, std::span<const ImageTransfer> images)
+    {
+        uint32_t srcQueueFamilyIndex = getLane(after.lane).p_queue->getQueueFamilyIndex();
+        uint32_t dstQueueFamilyIndex = getLane(destination).p_queue->getQueueFamilyIndex();
+        bool release = srcQueueFamilyIndex != dstQueueFamilyIndex;
+
+        auto recordBarriers = [&](bool acquire)
+        {
+            return [&, acquire](const vk::raii::CommandBuffer& commandBuffer)
+            {
+                auto bufferBarriers = std::ranges::to<std::vector<vk::BufferMemoryBarrier2>>(buffers 
+                    | std::ranges::views::transform([&](const BufferTransfer& transfer)
+                    {
+                        return vk::BufferMemoryBarrier2{
+                            !acquire || !release ? transfer.srcStageMask : vk::PipelineStageFlagBits2::eNone,
+                            !acquire || !release ? transfer.srcAccessMask : vk::AccessFlagBits2::eNone,
+                            acquire ? transfer.dstStageMask : vk::PipelineStageFlagBits2::eNone,
+                            acquire ? transfer.dstAccessMask : vk::AccessFlagBits2::eNone,
+                            release ? srcQueueFamilyIndex : vk::QueueFamilyIgnored,
+                            release ? dstQueueFamilyIndex : vk::QueueFamilyIgnored,
+                            transfer.buffer, transfer.offset, transfer.size };
+                    }));
+
+                auto imageBarriers = std::ranges::to<std::vector<vk::ImageMemoryBarrier2>>(images 
+                    | std::ranges::views::transform([&](const ImageTransfer& transfer)
+                    {
+                        return vk::ImageMemoryBarrier2{
+                            !acquire || !release ? transfer.srcStageMask : vk::PipelineStageFlagBits2::eNone,
+                            !acquire || !release ? transfer.srcAccessMask : vk::AccessFlagBits2::eNone,
+                            acquire ? transfer.dstStageMask : vk::PipelineStageFlagBits2::eNone,
+                            acquire ? transfer.dstAccessMask : vk::AccessFlagBits2::eNone,
+                            transfer.oldLayout, transfer.newLayout,
+                            release ? srcQueueFamilyIndex : vk::QueueFamilyIgnored,
+                            release ? dstQueueFamilyIndex : vk::QueueFamilyIgnored,
+                            transfer.image, transfer.subresourceRange };
+                    }));
+
+                commandBuffer.pipelineBarrier2(vk::DependencyInfo{}
+                    .setBufferMemoryBarriers(bufferBarriers)
+                    .setImageMemoryBarriers(imageBarriers));
+            };
+        };
+
+        if(buffers.empty() && images.empty())
+            return submit(destination, [](const vk::raii::CommandBuffer&){}, std::span{&after, 1});
+
+        if(release)
+            after = submit(after.lane, recordBarriers(false), std::span{&after, 1});
+
+        return submit(destination, recordBarriers(true), std::span{&after, 1});
+    }
+
+    bool QueueOrchestrator::isComplete(Ticket ticket) const
+    {
+        return getLane(ticket.lane).semaphore->getValue() >= ticket.value;
+    }
+
+    void QueueOrchestrator::wait(Ticket ticket) const
+    {
+        getLane(ticket.lane).semaphore->wait(ticket.value);
+    }
+
+    QueueAllocator::QueueAllocator(const Device& device, const CreateInfo& createInfo)
+        : policy{createInfo.policy}
+    {
+        if(!device.getEnabledFeatures().synchronization2 || !device.getEnabledFeatures().timelineSemaphore)
+            throw std::runtime_error("vke::QueueAllocator requires the synchronization2 and timelineSemaphore features");
+
+        auto queueFamilyProperties = device.getPhysicalDevice().getQueueFamilyProperties();
+        for(const auto& [queueFamilyIndex, properties] : queueFamilyProperties | std::views::enumerate)
+        {
+            vk::QueueFlags queueFlags = properties.queueFlags;
+            if(queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))
+                queueFlags |= vk::QueueFlagBits::eTransfer;
+
+            for(const DeviceQueue& queue : device.getDeviceQueues(static_cast<uint32_t>(queueFamilyIndex)))
+            {
+                auto& slot = slots.emplace_back(std::make_unique<Slot>());
+                slot->p_queue = &queue;
+                slot->queueFlags = queueFlags & capabilityMask;
+                slot->semaphore.emplace(device);
+                slotIndex.emplace(&queue, slot.get());
+            }
+        }
+
+        for(uint32_t key = 0; key < capabilityIndex.size(); ++key)
+        {
+            auto& candidates = capabilityIndex[key];
+            for(const auto& slot : slots)
+            {
+                if((getCapabilityKey(slot->queueFlags) & key) != key)
+                    continue;
+                candidates.push_back(slot.get());
+            }
+
+            std::ranges::stable_sort(candidates, std::ranges::less{}, 
+                [](const Slot* slot){ return std::popcount(getCapabilityKey(slot->queueFlags)); });
+        }
+    }
+
+    std::vector<std::vector<DeviceQueueInfo>> QueueAllocator::getAllQueueInfos(const vk::raii::PhysicalDevice& physicalDevice, float queuePriority)
+    {
+        return std::ranges::to<std::vector<std::vector<DeviceQueueInfo>>>(physicalDevice.getQueueFamilyProperties() 
+            | std::ranges::views::transform([&](const vk::QueueFamilyProperties& properties)
+            {
+                return std::vector<DeviceQueueInfo>(properties.queueCount, DeviceQueueInfo{ properties.queueFlags, queuePriority });
+            }));
+    }
+
+    const DeviceQueue& QueueAllocator::acquire(vk::QueueFlags requiredFlags)
+    {
+        const auto& candidates = capabilityIndex[getCapabilityKey(requiredFlags)];
+        if(candidates.empty())
+            throw std::runtime_error("vke::QueueAllocator has no queue with the requested capabilities");
+
+        uint32_t start = roundRobinCounters[getCapabilityKey(requiredFlags)].fetch_add(1, std::memory_order_relaxed);
+        if(policy == Policy::eRoundRobin)
+            return *candidates[start % candidates.size()]->p_queue;
+
+        const Slot* best = nullptr;
+        uint64_t bestLoad = UINT64_MAX;
+        int bestSpecificity = 0;
+        for(size_t i = 0; i < candidates.size(); ++i)
+        {
+            const Slot* slot = candidates[(start + i) % candidates.size()];
+            int specificity = std::popcount(getCapabilityKey(slot->queueFlags));
+            uint64_t load = getOutstandingCount(*slot);
+            if(!best || load < bestLoad || (load == bestLoad && specificity < bestSpecificity))
+            {
+                best = slot;
+                bestLoad = load;
+                bestSpecificity = specificity;
+            }
+        }
+        return *best->p_queue;
+    }
+
+    void QueueAllocator::submit(const DeviceQueue& queue, std::span<const vk::SubmitInfo2> submitInfos, vk::Fence fence)
+    {
+        VKE_ZONE("QueueAllocator::submit");
+        auto it = slotIndex.find(&queue);
+        if(it == slotIndex.end())
+            throw std::runtime_error("vke::QueueAllocator::submit called with a queue it does not own");
+        Slot& slot = *it->second;
+
+        std::lock_guard lock{slot.mutex};
+
+        uint64_t value = slot.submittedValue.load(std::memory_order_relaxed) + 1;
+        std::vector<vk::SubmitInfo2> submits{ submitInfos.begin(), submitInfos.end() };
+        if(submits.empty())
+            submits.emplace_back();
+
+        std::vector<vk::SemaphoreSubmitInfo> signalInfos{ submits.back().pSignalSemaphoreInfos, 
+            submits.back().pSignalSemaphoreInfos + submits.back().signalSemaphoreInfoCount };
+        signalInfos.emplace_back(*slot.semaphore, value, vk::PipelineStageFlagBits2::eAllCommands);
+        submits.back().setSignalSemaphoreInfos(signalInfos);
+
+        queue.submit2(submits, fence);
+        slot.submittedValue.store(value, std::memory_order_release);
+    }
+
+    uint64_t QueueAllocator::getOutstandingCount(const DeviceQueue& queue) const
+    {
+        auto it = slotIndex.find(&queue);
+        return it == slotIndex.end() ? 0 : getOutstandingCount(*it->second);
+    }
+
+    uint32_t QueueAllocator::getCapabilityKey(vk::QueueFlags queueFlags) noexcept
+    {
+        return (queueFlags & vk::QueueFlagBits::eGraphics ? 1u : 0u) |
+            (queueFlags & vk::QueueFlagBits::eCompute ? 2u : 0u) |
+            (queueFlags & vk::QueueFlagBits::eTransfer ? 4u : 0u);
+    }
+
+    uint64_t QueueAllocator::getOutstandingCount(const Slot& slot) const
+    {
+        uint64_t submitted = slot.submittedValue.load(std::memory_order_acquire);
+        uint64_t completed = slot.semaphore->getValue();
+        return submitted > completed ? submitted - completed : 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Base.hpp"
+#include "Synchronization.hpp"
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace vke{
+
+    class QueueOrchestrator
+    {
+    public:
+        enum class Lane : uint32_t
+        {
+            eGraphics,
+            eCompute,
+            eTransfer
+        };
+
+        struct Ticket
+        {
+            Lane lane = Lane::eGraphics;
+            uint64_t value = 0;
+        };
+
+        struct BufferTransfer
+        {
+            vk::Buffer buffer;
+            vk::DeviceSize offset = 0;
+            vk::DeviceSize size = vk::WholeSize;
+            vk::PipelineStageFlags2 srcStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+            vk::AccessFlags2 srcAccessMask = vk::AccessFlagBits2::eMemoryWrite;
+            vk::PipelineStageFlags2 dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+            vk::AccessFlags2 dstAccessMask = vk::AccessFlagBits2::eMemoryRead;
+        };
+
+        struct ImageTransfer
+        {
+            vk::Image image;
+            vk::ImageSubresourceRange subresourceRange{ vk::ImageAspectFlagBits::eColor, 0, vk::RemainingMipLevels, 0, vk::RemainingArrayLayers };
+            vk::ImageLayout oldLayout = vk::ImageLayout::eTransferDstOptimal;
+            vk::ImageLayout newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+            vk::PipelineStageFlags2 srcStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+            vk::AccessFlags2 srcAccessMask = vk::AccessFlagBits2::eMemoryWrite;
+            vk::PipelineStageFlags2 dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+            vk::AccessFlags2 dstAccessMask = vk::AccessFlagBits2::eMemoryRead;
+        };
+
+        using RecordFunction = std::function<void(const vk::raii::CommandBuffer& commandBuffer)>;
+
+        explicit QueueOrchestrator(const Device& device);
+
+        QueueOrchestrator(const QueueOrchestrator&) = delete;
+        QueueOrchestrator& operator=(const QueueOrchestrator&) = delete;
+
+        static std::vector<std::vector<DeviceQueueInfo>> addDedicatedQueueInfos(const vk::raii::PhysicalDevice& physicalDevice, 
+            std::vector<std::vector<DeviceQueueInfo>> deviceQueueInfos, uint32_t queueUsageFlags = 0, float queuePriority = 1.0f);
+
+        Ticket submit(Lane lane, const RecordFunction& recordFunction, std::span<const Ticket> waits = {});
+        Ticket dispatch(const RecordFunction& recordFunction, std::span<const Ticket> waits = {});
+        Ticket upload(const RecordFunction& recordFunction, std::span<const BufferTransfer> buffers, std::span<const ImageTransfer> images, 
+            Lane destination = Lane::eGraphics);
+        Ticket transferOwnership(Ticket after, Lane destination, std::span<const BufferTransfer> buffers, std::span<const ImageTransfer> images);
+
+        bool isComplete(Ticket ticket) const;
+        void wait(Ticket ticket) const;
+
+        inline const DeviceQueue& getQueue(Lane lane) const noexcept { return *lanes[static_cast<uint32_t>(lane)]->p_queue; }
+        inline vk::Semaphore getSemaphore(Lane lane) const noexcept { return *lanes[static_cast<uint32_t>(lane)]->semaphore; }
+        inline bool isDedicated(Lane lane) const noexcept { return lanes[static_cast<uint32_t>(lane)]->dedicated; }
+
+    private:
+        struct LaneState
+        {
+            const DeviceQueue* p_queue = nullptr;
+            bool dedicated = false;
+            std::optional<TimelineSemaphore> semaphore;
+            vk::raii::CommandPool commandPool{ nullptr };
+            std::mutex mutex;
+            uint64_t submittedValue = 0;
+            std::deque<std::pair<uint64_t, vk::raii::CommandBuffer>> inFlight;
+            std::vector<vk::raii::CommandBuffer> freeCommandBuffers;
+        };
+
+        const vk::raii::Device* p_device = nullptr;
+        std::array<std::unique_ptr<LaneState>, 3> lanes;
+
+        inline LaneState& getLane(Lane lane) const noexcept { return *lanes[static_cast<uint32_t>(lane)]; }
+    };
+
+    class QueueAllocator
+    {
+    public:
+        enum class Policy
+        {
+            eRoundRobin,
+            eLeastLoaded
+        };
+
+        struct CreateInfo
+        {
+            Policy policy = Policy::eLeastLoaded;
+        };
+
+        QueueAllocator(const Device& device, const CreateInfo& createInfo);
+
+        QueueAllocator(const QueueAllocator&) = delete;
+        QueueAllocator& operator=(const QueueAllocator&) = delete;
+
+        static std::vector<std::vector<DeviceQueueInfo>> getAllQueueInfos(const vk::raii::PhysicalDevice& physicalDevice, float queuePriority = 1.0f);
+
+        const DeviceQueue& acquire(vk::QueueFlags requiredFlags);
+        void submit(const DeviceQueue& queue, std::span<const vk::SubmitInfo2> submitInfos, vk::Fence fence = {});
+
+        uint64_t getOutstandingCount(const DeviceQueue& queue) const;
+        inline size_t getQueueCount() const noexcept { return slots.size(); }
+
+    private:
+        static constexpr vk::QueueFlags capabilityMask = vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute | vk::QueueFlagBits::eTransfer;
+
+        struct Slot
+        {
+            const DeviceQueue* p_queue = nullptr;
+            vk::QueueFlags queueFlags{};
+            std::optional<TimelineSemaphore> semaphore;
+            std::mutex mutex;
+            std::atomic<uint64_t> submittedValue{0};
+        };
+
+        Policy policy;
+        std::vector<std::unique_ptr<Slot>> slots;
+        std::unordered_map<const DeviceQueue*, Slot*> slotIndex;
+        std::array<std::vector<Slot*>, 8> capabilityIndex;
+        std::array<std::atomic<uint32_t>, 8> roundRobinCounters{};
+
+        static uint32_t getCapabilityKey(vk::QueueFlags queueFlags) noexcept;
+        uint64_t getOutstandingCount(const Slot& slot) const;
+    };
+
+}
\ No newline at end of file
@@ -1,31 +1,155 @@
 #include "Resources.hpp"
+#include "Instrumentation.hpp"
 
 #include <vulkan/vulkan_format_traits.hpp>
 
 #include <ranges>
+#include <thread>
+#include <fstream>
+#include <format>
 
 namespace vke{
-    Swapchain::Swapchain(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, CreateInfo&& createInfo_, vk::SwapchainKHR oldSwapchain)
-        : createInfo{std::move(createInfo_)}, swapchain{createSwapchain(device, physicalDevice, oldSwapchain)}, images{swapchain.getImages()} {}
+    Swapchain::Swapchain(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, CreateInfo&& createInfo_, 
+        vk::SwapchainKHR oldSwapchain, bool presentWait)
+        : createInfo{std::move(createInfo_)}, swapchain{createSwapchain(device, physicalDevice, oldSwapchain)}, images{swapchain->getImages()}, 
+        presentWaitEnabled{ presentWait } {}
 
     Swapchain::Swapchain(const Device& device, CreateInfo&& createInfo, vk::SwapchainKHR oldSwapchain)
-        : Swapchain{device, device.getPhysicalDevice(), std::move(createInfo), oldSwapchain } {}
+        : Swapchain{device, device.getPhysicalDevice(), std::move(createInfo), oldSwapchain, 
+            device.getEnabledFeatures().presentId && device.getEnabledFeatures().presentWait } {}
     
     void Swapchain::recreate(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice)
     {
-        vk::raii::SwapchainKHR newSwapchain = createSwapchain(device, physicalDevice, swapchain);
+        vk::raii::SwapchainKHR newSwapchain = createSwapchain(device, physicalDevice, *swapchain);
         swapchain = std::move(newSwapchain);
-        images = swapchain.getImages();
+        images = swapchain->getImages();
+        lastCompletedPresentId = lastPresentId;
+        fencePresentIds.clear();
     }
 
     void Swapchain::recreate(const Device& device)
     {
         recreate(device, device.getPhysicalDevice());
     }
+
+    void Swapchain::beginFrame(const vk::raii::Fence* frameFence)
+    {
+        PacingMode pacingMode = createInfo.pacingMode();
+
+        if(presentWaitEnabled)
+        {
+            uint64_t blockingPresentId = pacingMode == PacingMode::eNone ? 0 : lastPresentId;
+
+            for(uint64_t presentId = lastCompletedPresentId + 1; presentId <= lastPresentId; presentId++)
+            {
+                vk::Result result = vk::Result::eSuccess;
+                try
+                {
+                    result = swapchain->waitForPresent(presentId, presentId <= blockingPresentId ? UINT64_MAX : 0);
+                }
+                catch(const vk::OutOfDateKHRError&) {}
+
+                if(result == vk::Result::eTimeout)
+                    break;
+
+                completePresent(presentId, std::chrono::steady_clock::now(), true);
+            }
+        }
+        else if(frameFence)
+        {
+            vk::Fence fence = **frameFence;
+            auto it = std::ranges::find(fencePresentIds, fence, &std::pair<vk::Fence, uint64_t>::first);
+
+            if(it != fencePresentIds.end())
+            {
+                vk::Result result = static_cast<vk::Result>( frameFence->getDispatcher()->vkWaitForFences( 
+                    static_cast<VkDevice>( frameFence->getDevice() ), 1, reinterpret_cast<const VkFence*>(&fence), vk::True, UINT64_MAX) );
+                vk::detail::resultCheck( result, "vke::Swapchain::beginFrame" );
+
+                completePresent(it->second, std::chrono::steady_clock::now(), false);
+                it->second = lastPresentId + 1;
+            }
+            else
+            {
+                fencePresentIds.emplace_back(fence, lastPresentId + 1);
+            }
+        }
+
+        if(pacingMode == PacingMode::eLatencyTarget && presentInterval.count() > 0 && 
+            lastPresentCompleted != std::chrono::steady_clock::time_point{})
+        {
+            auto now = std::chrono::steady_clock::now();
+            auto nextPresent = lastPresentCompleted + ((now - lastPresentCompleted) / presentInterval + 1) * presentInterval;
+            auto frameBegin = nextPresent - createInfo.latencyTarget();
+
+            if(frameBegin > now)
+                std::this_thread::sleep_until(frameBegin);
+        }
+
+        currentFrameBegin = std::chrono::steady_clock::now();
+    }
+
+    vk::Result Swapchain::present(const DeviceQueue& queue, uint32_t imageIndex, vk::ArrayProxy<const vk::Semaphore> waitSemaphores)
+    {
+        VKE_ZONE("Swapchain::present");
+        uint64_t presentId = ++lastPresentId;
+        vk::SwapchainKHR presentSwapchain = *swapchain;
+
+        vk::PresentIdKHR presentIdInfo{1, &presentId};
+        vk::PresentInfoKHR presentInfo{};
+        presentInfo.setWaitSemaphoreCount(waitSemaphores.size());
+        presentInfo.setPWaitSemaphores(waitSemaphores.data());
+        presentInfo.setSwapchains(presentSwapchain);
+        presentInfo.setImageIndices(imageIndex);
+
+        if(presentWaitEnabled)
+            presentInfo.setPNext(&presentIdInfo);
+
+        frameLatencies[presentId % frameLatencyHistory] = FrameLatency{ 
+            .presentId = presentId, 
+            .frameBegin = currentFrameBegin, 
+            .presentQueued = std::chrono::steady_clock::now() };
+
+        return queue.presentKHR(presentInfo);
+    }
+
+    std::vector<Swapchain::FrameLatency> Swapchain::getFrameLatencies() const
+    {
+        uint64_t firstPresentId = lastCompletedPresentId >= frameLatencyHistory ? lastCompletedPresentId - frameLatencyHistory + 1 : 1;
+
+        return std::ranges::to<std::vector<FrameLatency>>(std::ranges::views::iota(firstPresentId, lastCompletedPresentId + 1)
+            | std::ranges::views::filter([this](uint64_t presentId) -> bool
+                {
+                    const FrameLatency& latency = frameLatencies[presentId % frameLatencyHistory];
+                    return latency.presentId == presentId && latency.presentCompleted != std::chrono::steady_clock::time_point{};
+                })
+            | std::ranges::views::transform([this](uint64_t presentId) -> FrameLatency { return frameLatencies[presentId % frameLatencyHistory]; }));
+    }
+
+    void Swapchain::completePresent(uint64_t presentId, std::chrono::steady_clock::time_point time, bool measuredByPresentWait)
+    {
+        FrameLatency& latency = frameLatencies[presentId % frameLatencyHistory];
+
+        if(latency.presentId == presentId)
+        {
+            latency.presentCompleted = time;
+            latency.measuredByPresentWait = measuredByPresentWait;
+        }
+
+        if(lastPresentCompleted != std::chrono::steady_clock::time_point{} && time > lastPresentCompleted)
+        {
+            auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(time - lastPresentCompleted);
+            presentInterval = presentInterval.count() == 0 ? interval : (presentInterval * 7 + interval) / 8;
+        }
+
+        lastPresentCompleted = time;
+        lastCompletedPresentId = std::max(lastCompletedPresentId, presentId);
+    }
         
     vk::raii::SwapchainKHR Swapchain::createSwapchain(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, 
         vk::SwapchainKHR oldSwapchain)
     {
+        VKE_ZONE("Swapchain::createSwapchain");
         nativeCreateInfo.surface = createInfo.surface();
         vk::SurfaceFormatKHR surfaceFormat = createInfo.surfaceFormatSelecter(physicalDevice.getSurfaceFormatsKHR(nativeCreateInfo.surface));
 
@@ -61,7 +185,7 @@ namespace vke{
     Image::Image(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, 
         CreateInfo&& createInfo_, DeviceMemoryAllocator<> deviceMemoryAllocator)
         : createInfo{ std::move(createInfo_) }, image{ createImage(device, physicalDevice) },
-        memory_{ deviceMemoryAllocator.allocate(device, physicalDevice, image.getMemoryRequirements()) }
+        memory_{ deviceMemoryAllocator.allocate(device, physicalDevice, image->getMemoryRequirements()) }
     {
         memory_.bind(image);
     }
@@ -72,7 +196,7 @@ namespace vke{
     void Image::recreate(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, DeviceMemoryAllocator<> deviceMemoryAllocator)
     {
         image = createImage(device, physicalDevice);
-        memory_ = deviceMemoryAllocator.allocate(device, physicalDevice, image.getMemoryRequirements());
+        memory_ = deviceMemoryAllocator.allocate(device, physicalDevice, image->getMemoryRequirements());
         memory_.bind(image);
     }
 
@@ -83,6 +207,7 @@ namespace vke{
         
     vk::raii::Image Image::createImage(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice)
     {
+        VKE_ZONE("Image::createImage");
         nativeCreateInfo.setFlags(createInfo.flags());
         nativeCreateInfo.setTiling(createInfo.tiling());
         nativeCreateInfo.setUsage(createInfo.usage());
@@ -184,7 +309,7 @@ namespace vke{
     {
         vk::ImageViewCreateInfo viewCreateInfo{};
 
-        viewCreateInfo.setImage(image);
+        viewCreateInfo.setImage(*image);
         viewCreateInfo.setViewType(createInfo_.viewType(static_cast<vk::ImageViewType>(nativeCreateInfo.imageType)));
         viewCreateInfo.setFlags(createInfo_.flags());
         viewCreateInfo.setFormat(createInfo_.format(nativeCreateInfo.format));
@@ -202,4 +327,243 @@ namespace vke{
 
         return vk::raii::ImageView{device, viewCreateInfo};
     }
+
+    VirtualSwapchain::VirtualSwapchain(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, 
+        CreateInfo&& createInfo_, DeviceMemoryAllocator<> deviceMemoryAllocator)
+        : createInfo{ std::move(createInfo_) }, p_device{ &device }, 
+        commandPool{ device, vk::CommandPoolCreateInfo{ {}, createInfo.queueFamilyIndex() } },
+        frames{ createFrames(device, physicalDevice, deviceMemoryAllocator) } {}
+
+    VirtualSwapchain::VirtualSwapchain(const Device& device, CreateInfo&& createInfo, DeviceMemoryAllocator<> deviceMemoryAllocator)
+        : VirtualSwapchain{device, device.getPhysicalDevice(), std::move(createInfo), deviceMemoryAllocator} {}
+
+    VirtualSwapchain::~VirtualSwapchain()
+    {
+        for(const Frame& frame : frames)
+        {
+            if(!frame.pending)
+                continue;
+
+            VkFence fence = static_cast<VkFence>(*frame.presentFence);
+            p_device->getDispatcher()->vkWaitForFences(static_cast<VkDevice>(**p_device), 1, &fence, vk::True, UINT64_MAX);
+        }
+    }
+
+    std::pair<vk::Result, uint32_t> VirtualSwapchain::acquireNextImage(const DeviceQueue& queue, vk::Semaphore semaphore, vk::Fence fence)
+    {
+        uint32_t imageIndex = nextImageIndex;
+        nextImageIndex = (nextImageIndex + 1) % frames.size();
+
+        retire(imageIndex);
+
+        if(semaphore || fence)
+        {
+            vk::SubmitInfo submitInfo{};
+            if(semaphore)
+                submitInfo.setSignalSemaphores(semaphore);
+
+            queue.submit(submitInfo, fence);
+        }
+
+        return { createInfo.imageExtent() == extent ? vk::Result::eSuccess : vk::Result::eSuboptimalKHR, imageIndex };
+    }
+
+    vk::Result VirtualSwapchain::present(const DeviceQueue& queue, uint32_t imageIndex, vk::ArrayProxy<const vk::Semaphore> waitSemaphores)
+    {
+        Frame& frame = frames[imageIndex];
+
+        p_device->resetFences(*frame.presentFence);
+
+        std::vector<vk::PipelineStageFlags> waitStages(waitSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands);
+
+        vk::SubmitInfo submitInfo{};
+        submitInfo.setWaitSemaphoreCount(waitSemaphores.size());
+        submitInfo.setPWaitSemaphores(waitSemaphores.data());
+        submitInfo.setWaitDstStageMask(waitStages);
+
+        vk::CommandBuffer commandBuffer = *frame.readbackCommandBuffer;
+        if(commandBuffer)
+            submitInfo.setCommandBuffers(commandBuffer);
+
+        queue.submit(submitInfo, *frame.presentFence);
+
+        frame.presentId = ++lastPresentId;
+        frame.pending = true;
+
+        return createInfo.imageExtent() == extent ? vk::Result::eSuccess : vk::Result::eSuboptimalKHR;
+    }
+
+    void VirtualSwapchain::flush()
+    {
+        for(uint32_t offset = 0; offset < frames.size(); offset++)
+        {
+            retire((nextImageIndex + offset) % frames.size());
+        }
+    }
+
+    vk::raii::ImageView VirtualSwapchain::createImageView(const vk::raii::Device& device, const Image::ViewCreateInfo& createInfo_, uint32_t imageIndex) const
+    {
+        return frames[imageIndex].image.createImageView(device, createInfo_);
+    }
+
+    void VirtualSwapchain::recreate(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, DeviceMemoryAllocator<> deviceMemoryAllocator)
+    {
+        flush();
+
+        frames = createFrames(device, physicalDevice, deviceMemoryAllocator);
+        nextImageIndex = 0;
+    }
+
+    void VirtualSwapchain::recreate(const Device& device, DeviceMemoryAllocator<> deviceMemoryAllocator)
+    {
+        recreate(device, device.getPhysicalDevice(), deviceMemoryAllocator);
+    }
+
+    VirtualSwapchain::Sink VirtualSwapchain::createFileSink(std::filesystem::path directory)
+    {
+        std::filesystem::create_directories(directory);
+
+        return [directory = std::move(directory)](const PresentedImage& presentedImage)
+        {
+            if(presentedImage.pixels.empty())
+                return;
+
+            bool bgra = presentedImage.format == vk::Format::eB8G8R8A8Unorm || presentedImage.format == vk::Format::eB8G8R8A8Srgb;
+            bool rgba = presentedImage.format == vk::Format::eR8G8B8A8Unorm || presentedImage.format == vk::Format::eR8G8B8A8Srgb;
+
+            if(!bgra && !rgba)
+            {
+                std::ofstream file{directory / std::format("frame_{}.bin", presentedImage.presentId), std::ios::binary};
+                file.write(reinterpret_cast<const char*>(presentedImage.pixels.data()), presentedImage.pixels.size());
+                return;
+            }
+
+            std::ofstream file{directory / std::format("frame_{}.ppm", presentedImage.presentId), std::ios::binary};
+            file << std::format("P6\n{} {}\n255\n", presentedImage.extent.width, presentedImage.extent.height);
+
+            std::vector<char> row(presentedImage.extent.width * 3);
+            for(uint32_t y = 0; y < presentedImage.extent.height; y++)
+            {
+                const std::byte* pixel = presentedImage.pixels.data() + static_cast<size_t>(y) * presentedImage.extent.width * 4;
+                for(uint32_t x = 0; x < presentedImage.extent.width; x++, pixel += 4)
+                {
+                    row[x * 3 + 0] = static_cast<char>(pixel[bgra ? 2 : 0]);
+                    row[x * 3 + 1] = static_cast<char>(pixel[1]);
+                    row[x * 3 + 2] = static_cast<char>(pixel[bgra ? 0 : 2]);
+                }
+                file.write(row.data(), row.size());
+            }
+        };
+    }
+
+    std::vector<VirtualSwapchain::Frame> VirtualSwapchain::createFrames(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, 
+        DeviceMemoryAllocator<> deviceMemoryAllocator)
+    {
+        extent = createInfo.imageExtent();
+
+        bool readback = createInfo.readback();
+        vk::ImageLayout presentLayout = createInfo.presentLayout();
+        uint32_t imageCount = std::max(createInfo.imageCount(), 1u);
+
+        vk::ImageUsageFlags usage = createInfo.imageUsage();
+        vk::FormatFeatureFlags formatFeatures = vk::FormatFeatureFlagBits::eColorAttachment;
+        if(readback)
+        {
+            usage |= vk::ImageUsageFlagBits::eTransferSrc;
+            formatFeatures |= vk::FormatFeatureFlagBits::eTransferSrc;
+        }
+
+        vk::raii::CommandBuffers commandBuffers{ nullptr };
+        if(readback)
+        {
+            if(!readbackMemory)
+            {
+                readbackUpstream = std::make_unique<NewDeleteDeviceMemoryResource>(device, physicalDevice);
+                readbackMemory = std::make_unique<MappedDeviceMemoryResource>(physicalDevice, readbackUpstream.get());
+            }
+            commandBuffers = vk::raii::CommandBuffers{ device, vk::CommandBufferAllocateInfo{ *commandPool, vk::CommandBufferLevel::ePrimary, imageCount } };
+        }
+
+        std::vector<Frame> newFrames{};
+        newFrames.reserve(imageCount);
+
+        for(uint32_t imageIndex = 0; imageIndex < imageCount; imageIndex++)
+        {
+            Frame frame{ 
+                .image = Image{device, physicalDevice, Image::CreateInfo{
+                    .usage = usage,
+                    .formatFeatureFlags = formatFeatures,
+                    .formatSelecter = createInfo.formatSelecter,
+                    .extent = vk::Extent3D{extent, 1},
+                    .queueFamilyIndices = std::vector<uint32_t>{ createInfo.queueFamilyIndex() }
+                }, deviceMemoryAllocator},
+                .presentFence = vk::raii::Fence{ device, vk::FenceCreateInfo{} } };
+
+            if(readback)
+            {
+                frame.readbackBuffer.emplace(device, physicalDevice, BufferWrapper::CreateInfo{
+                    .size = static_cast<vk::DeviceSize>(extent.width) * extent.height * vk::blockSize(frame.image.getFormat()),
+                    .usage = vk::BufferUsageFlags{vk::BufferUsageFlagBits::eTransferDst}
+                }, DeviceMemoryAllocator<std::byte>{*readbackMemory});
+                frame.readbackCommandBuffer = std::move(commandBuffers[imageIndex]);
+
+                const vk::raii::CommandBuffer& commandBuffer = frame.readbackCommandBuffer;
+                vk::Image image = frame.image;
+                vk::ImageSubresourceRange range{ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 };
+
+                commandBuffer.begin(vk::CommandBufferBeginInfo{});
+
+                if(presentLayout != vk::ImageLayout::eTransferSrcOptimal)
+                {
+                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, 
+                        vk::ImageMemoryBarrier{ vk::AccessFlagBits::eMemoryWrite, vk::AccessFlagBits::eTransferRead, 
+                            presentLayout, vk::ImageLayout::eTransferSrcOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, range });
+                }
+
+                commandBuffer.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, static_cast<vk::Buffer>(*frame.readbackBuffer), 
+                    vk::BufferImageCopy{ 0, 0, 0, { vk::ImageAspectFlagBits::eColor, 0, 0, 1 }, { 0, 0, 0 }, vk::Extent3D{extent, 1} });
+
+                if(presentLayout != vk::ImageLayout::eTransferSrcOptimal && presentLayout != vk::ImageLayout::eUndefined)
+                {
+                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, 
+                        vk::ImageMemoryBarrier{ vk::AccessFlagBits::eTransferRead, vk::AccessFlags{}, 
+                            vk::ImageLayout::eTransferSrcOptimal, presentLayout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, range });
+                }
+
+                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, 
+                    vk::MemoryBarrier{ vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead }, {}, {});
+
+                commandBuffer.end();
+            }
+
+            newFrames.emplace_back(std::move(frame));
+        }
+
+        return newFrames;
+    }
+
+    void VirtualSwapchain::retire(uint32_t imageIndex)
+    {
+        Frame& frame = frames[imageIndex];
+
+        if(!frame.pending)
+            return;
+
+        vk::Result result = p_device->waitForFences(*frame.presentFence, vk::True, UINT64_MAX);
+        vk::detail::resultCheck( result, "vke::VirtualSwapchain::retire" );
+
+        frame.pending = false;
+
+        if(createInfo.sink)
+        {
+            PresentedImage presentedImage{ imageIndex, frame.presentId, frame.image.getFormat(), extent };
+            if(frame.readbackBuffer)
+            {
+                frame.readbackBuffer->invalidate();
+                presentedImage.pixels = std::span<const std::byte>{ frame.readbackBuffer->data(), frame.readbackBuffer->size() };
+            }
+
+            createInfo.sink(presentedImage);
+        }
+    }
 }
\ No newline at end of file
@@ -3,10 +3,21 @@
 #include "Base.hpp"
 #include "Memory.hpp"
 
+#include <chrono>
+#include <filesystem>
+#include <optional>
+
 namespace vke{
     class Swapchain
     {
     public:
+        enum class PacingMode
+        {
+            eNone,
+            eLowLatency,
+            eLatencyTarget
+        };
+
         struct CreateInfo
         {
             Getter<vk::SurfaceKHR> surface;
@@ -20,10 +31,25 @@ namespace vke{
             Selecter<vk::CompositeAlphaFlagsKHR> compositeAlphaSelecter{ nullptr, vk::CompositeAlphaFlagBitsKHR::eOpaque };
             Getter<std::vector<uint32_t>> queueFamilyIndices{std::vector<uint32_t>{}};
             Getter<vk::Bool32> clipped{vk::True};
+            Getter<PacingMode> pacingMode{PacingMode::eNone};
+            Getter<std::chrono::nanoseconds> latencyTarget{std::chrono::nanoseconds{0}};
+        };
+
+        struct FrameLatency
+        {
+            uint64_t presentId = 0;
+            std::chrono::steady_clock::time_point frameBegin{};
+            std::chrono::steady_clock::time_point presentQueued{};
+            std::chrono::steady_clock::time_point presentCompleted{};
+            bool measuredByPresentWait = false;
+
+            inline std::chrono::nanoseconds getPresentLatency() const noexcept { return presentCompleted - presentQueued; }
+            inline std::chrono::nanoseconds getFrameLatency() const noexcept { return presentCompleted - frameBegin; }
         };
  
+        // presentWait requires VK_KHR_present_id and VK_KHR_present_wait with both features enabled on the device.
         Swapchain(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, CreateInfo&& createInfo, 
-            vk::SwapchainKHR oldSwapchain = {nullptr});
+            vk::SwapchainKHR oldSwapchain = {nullptr}, bool presentWait = false);
         Swapchain(const Device& device, CreateInfo&& createInfo, vk::SwapchainKHR oldSwapchain = {nullptr});
         
         Swapchain(Swapchain&&) noexcept = default;
@@ -49,19 +75,37 @@ namespace vke{
         void recreate(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice);
         void recreate(const Device& device);
 
+        void beginFrame(const vk::raii::Fence* frameFence = nullptr);
+        vk::Result present(const DeviceQueue& queue, uint32_t imageIndex, vk::ArrayProxy<const vk::Semaphore> waitSemaphores = {});
+
+        std::vector<FrameLatency> getFrameLatencies() const;
+
         inline vk::Format getFormat() const noexcept { return nativeCreateInfo.imageFormat; }
         inline uint32_t getImageCount() const noexcept { return images.size(); }
+        inline bool isPresentWaitEnabled() const noexcept { return presentWaitEnabled; }
 
         inline operator const vk::raii::SwapchainKHR & () const & noexcept { return swapchain; }
-        inline operator vk::SwapchainKHR () const & noexcept { return swapchain; }
-        inline const auto* operator->() const & noexcept { return &swapchain; }
+        inline operator vk::SwapchainKHR () const & noexcept { return *swapchain; }
+        inline const auto* operator->() const & noexcept { return &swapchain.get(); }
 
     private:
         vk::SwapchainCreateInfoKHR nativeCreateInfo{};
         CreateInfo createInfo;
-        vk::raii::SwapchainKHR swapchain{ nullptr };
+        DeferredHandle<vk::raii::SwapchainKHR> swapchain{ nullptr };
         std::vector<vk::Image> images;
 
+        static constexpr uint64_t frameLatencyHistory = 64;
+
+        bool presentWaitEnabled = false;
+        uint64_t lastPresentId = 0;
+        uint64_t lastCompletedPresentId = 0;
+        std::chrono::steady_clock::time_point currentFrameBegin{};
+        std::chrono::steady_clock::time_point lastPresentCompleted{};
+        std::chrono::nanoseconds presentInterval{0};
+        std::vector<FrameLatency> frameLatencies = std::vector<FrameLatency>(frameLatencyHistory);
+        std::vector<std::pair<vk::Fence, uint64_t>> fencePresentIds;
+
+        void completePresent(uint64_t presentId, std::chrono::steady_clock::time_point time, bool measuredByPresentWait);
         vk::raii::SwapchainKHR createSwapchain(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, vk::SwapchainKHR oldSwapchain);
     };
 
@@ -81,7 +125,7 @@ namespace vke{
         BufferWrapper(BufferWrapper&&) noexcept = default;
         BufferWrapper& operator=(BufferWrapper&&) noexcept = default;
 
-        vk::raii::Buffer buffer{ nullptr };
+        DeferredHandle<vk::raii::Buffer> buffer{ nullptr };
     };
     
     template<class T = void>
@@ -100,8 +144,8 @@ namespace vke{
             DeviceMemoryAllocator<T> deviceMemoryAllocator = DeviceMemoryAllocator<T>{})
             : buffer{device, physicalDevice, createInfo}
         {
-            memory_ = deviceMemoryAllocator.allocate(device, physicalDevice, buffer.buffer.getMemoryRequirements());
-            memory_.bind(buffer);
+            memory_ = deviceMemoryAllocator.allocate(device, physicalDevice, buffer.buffer->getMemoryRequirements());
+            memory_.bind(buffer.buffer);
         }
         Buffer(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, const CreateInfo& createInfo, 
             DeviceMemoryAllocator<T> deviceMemoryAllocator = DeviceMemoryAllocator<T>{})
@@ -114,7 +158,7 @@ namespace vke{
                     .usage = createInfo.usage(),
                     .queueFamilyIndices = createInfo.queueFamilyIndices()
                 }};
-            memory_ = deviceMemoryAllocator.allocate(device, physicalDevice, buffer.buffer.getMemoryRequirements());
+            memory_ = deviceMemoryAllocator.allocate(device, physicalDevice, buffer.buffer->getMemoryRequirements());
             memory_.bind(buffer.buffer);
             std::ranges::copy(data, memory_.data());
         }
@@ -127,8 +171,14 @@ namespace vke{
         Buffer& operator=(Buffer&&) noexcept = default;
 
         inline operator const vk::raii::Buffer & () const & noexcept { return buffer.buffer; }
-        inline operator vk::Buffer () const & noexcept { return buffer.buffer; }
-        inline const auto* operator->() const & noexcept { return &buffer.buffer; }
+        inline operator vk::Buffer () const & noexcept { return *buffer.buffer; }
+        inline const auto* operator->() const & noexcept { return &buffer.buffer.get(); }
+
+        inline T* data() noexcept { return memory_.data(); }
+        inline size_t size() noexcept { return memory_.size(); }
+
+        inline void flush() const { memory_.flush(); }
+        inline void invalidate() const { memory_.invalidate(); }
 
     private:
         BufferWrapper buffer{};
@@ -180,8 +230,8 @@ namespace vke{
         vk::raii::ImageView createImageView(const vk::raii::Device& device, const ViewCreateInfo& createInfo) const;
 
         inline operator const vk::raii::Image & () const & noexcept { return image; }
-        inline operator vk::Image () const & noexcept { return image; }
-        inline const auto* operator->() const & noexcept { return &image; }
+        inline operator vk::Image () const & noexcept { return *image; }
+        inline const auto* operator->() const & noexcept { return &image.get(); }
 
         inline vk::Format getFormat() const noexcept { return nativeCreateInfo.format; }
         inline vk::SampleCountFlagBits getSamples() const noexcept { return nativeCreateInfo.samples; }
@@ -193,9 +243,86 @@ namespace vke{
     private:
         vk::ImageCreateInfo nativeCreateInfo{};
         CreateInfo createInfo;
-        vk::raii::Image image{ nullptr };
+        DeferredHandle<vk::raii::Image> image{ nullptr };
         DeviceMemory<void> memory_{};
 
         vk::raii::Image createImage(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice);
     };
+
+    class VirtualSwapchain
+    {
+    public:
+        struct PresentedImage
+        {
+            uint32_t imageIndex = 0;
+            uint64_t presentId = 0;
+            vk::Format format = vk::Format::eUndefined;
+            vk::Extent2D extent{};
+            std::span<const std::byte> pixels{};
+        };
+
+        using Sink = std::function<void(const PresentedImage&)>;
+
+        struct CreateInfo
+        {
+            Getter<vk::Extent2D> imageExtent;
+            Getter<uint32_t> imageCount{3};
+            Selecter<vk::Format> formatSelecter{ nullptr, std::vector{vk::Format::eB8G8R8A8Unorm, vk::Format::eR8G8B8A8Unorm} };
+            Getter<vk::ImageUsageFlags> imageUsage{ vk::ImageUsageFlags{vk::ImageUsageFlagBits::eColorAttachment} };
+            Getter<vk::ImageLayout> presentLayout{ vk::ImageLayout::eTransferSrcOptimal };
+            Getter<uint32_t> queueFamilyIndex{0};
+            Getter<bool> readback{false};
+            Sink sink = nullptr;
+        };
+
+        VirtualSwapchain(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, CreateInfo&& createInfo, 
+            DeviceMemoryAllocator<> deviceMemoryAllocator = DeviceMemoryAllocator<>{});
+        VirtualSwapchain(const Device& device, CreateInfo&& createInfo, DeviceMemoryAllocator<> deviceMemoryAllocator = DeviceMemoryAllocator<>{});
+        ~VirtualSwapchain();
+
+        VirtualSwapchain(VirtualSwapchain&&) noexcept = default;
+        VirtualSwapchain& operator=(VirtualSwapchain&&) noexcept = default;
+
+        std::pair<vk::Result, uint32_t> acquireNextImage(const DeviceQueue& queue, vk::Semaphore semaphore = {}, vk::Fence fence = {});
+        vk::Result present(const DeviceQueue& queue, uint32_t imageIndex, vk::ArrayProxy<const vk::Semaphore> waitSemaphores = {});
+        // Hands every pending frame to the sink. The destructor only waits for them, so call this before destruction.
+        void flush();
+
+        vk::raii::ImageView createImageView(const vk::raii::Device& device, const Image::ViewCreateInfo& createInfo, uint32_t imageIndex) const;
+
+        void recreate(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, DeviceMemoryAllocator<> deviceMemoryAllocator = DeviceMemoryAllocator<>{});
+        void recreate(const Device& device, DeviceMemoryAllocator<> deviceMemoryAllocator = DeviceMemoryAllocator<>{});
+
+        inline vk::Format getFormat() const noexcept { return frames.front().image.getFormat(); }
+        inline vk::Extent2D getExtent() const noexcept { return extent; }
+        inline uint32_t getImageCount() const noexcept { return frames.size(); }
+        inline const Image& getImage(uint32_t imageIndex) const noexcept { return frames[imageIndex].image; }
+
+        static Sink createFileSink(std::filesystem::path directory);
+
+    private:
+        struct Frame
+        {
+            Image image;
+            vk::raii::Fence presentFence{ nullptr };
+            vk::raii::CommandBuffer readbackCommandBuffer{ nullptr };
+            std::optional<Buffer<std::byte>> readbackBuffer{};
+            uint64_t presentId = 0;
+            bool pending = false;
+        };
+
+        CreateInfo createInfo;
+        const vk::raii::Device* p_device = nullptr;
+        vk::raii::CommandPool commandPool{ nullptr };
+        std::unique_ptr<NewDeleteDeviceMemoryResource> readbackUpstream{};
+        std::unique_ptr<MappedDeviceMemoryResource> readbackMemory{};
+        vk::Extent2D extent{};
+        std::vector<Frame> frames;
+        uint32_t nextImageIndex = 0;
+        uint64_t lastPresentId = 0;
+
+        std::vector<Frame> createFrames(const vk::raii::Device& device, const vk::raii::PhysicalDevice& physicalDevice, 
+            DeviceMemoryAllocator<> deviceMemoryAllocator);
+        void retire(uint32_t imageIndex);
+    };
 }
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include "Shader.hpp"
+
+#include <spirv_reflect.h>
+#include <vulkan/vulkan_format_traits.hpp>
+
+#include <fstream>
+#include <format>
+#include <map>
+
+namespace vke{
+
+    namespace {
+        template<class T>
+            requires std::is_trivially_copyable_v<T>
+        void appendKey(std::string& key, const T& value)
+        {
+            key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void reflectCheck(SpvReflectResult result, const char* message)
+        {
+            if(result != SPV_REFLECT_RESULT_SUCCESS)
+            {
+                throw std::runtime_error{std::format("{}, SPIR-V reflection failed with {}", message, static_cast<int>(result))};
+            }
+        }
+    }
+
+    ShaderModule::ShaderModule(const vk::raii::Device& device, std::span<const uint32_t> code)
+        : ShaderModule{device, code, reflect(code)} {}
+
+    ShaderModule::ShaderModule(const vk::raii::Device& device, std::span<const uint32_t> code, Reflection reflection_)
+        : reflection{std::move(reflection_)}, module{device, vk::ShaderModuleCreateInfo{ {}, code.size_bytes(), code.data() }} {}
+
+    ShaderModule::ShaderModule(const vk::raii::Device& device, const std::filesystem::path& path)
+        : ShaderModule{device, readFile(path)} {}
+
+    ShaderModule::ShaderModule(const vk::raii::Device& device, const Embedded& embedded)
+        : ShaderModule{device, embedded.code, embedded.reflection ? embedded.reflection() : reflect(embedded.code)} {}
+
+    ShaderModule::Reflection ShaderModule::reflect(std::span<const uint32_t> code)
+    {
+        SpvReflectShaderModule module{};
+        reflectCheck(spvReflectCreateShaderModule(code.size_bytes(), code.data(), &module), "vke::ShaderModule::reflect");
+
+        std::unique_ptr<SpvReflectShaderModule, decltype([](SpvReflectShaderModule* m){ spvReflectDestroyShaderModule(m); })> guard{&module};
+
+        Reflection reflection{};
+        reflection.stage = static_cast<vk::ShaderStageFlagBits>(module.shader_stage);
+        reflection.entryPoint = module.entry_point_name ? module.entry_point_name : "main";
+
+        {
+            uint32_t count = 0;
+            reflectCheck(spvReflectEnumerateDescriptorSets(&module, &count, nullptr), "vke::ShaderModule::reflect");
+            std::vector<SpvReflectDescriptorSet*> sets(count);
+            reflectCheck(spvReflectEnumerateDescriptorSets(&module, &count, sets.data()), "vke::ShaderModule::reflect");
+
+            for(const SpvReflectDescriptorSet* set : sets)
+            {
+                DescriptorSet& descriptorSet = reflection.descriptorSets.emplace_back(DescriptorSet{ set->set });
+                for(uint32_t index = 0; index < set->binding_count; index++)
+                {
+                    const SpvReflectDescriptorBinding* binding = set->bindings[index];
+                    descriptorSet.bindings.emplace_back(binding->binding, static_cast<vk::DescriptorType>(binding->descriptor_type), 
+                        binding->count, reflection.stage);
+                }
+
+                std::ranges::sort(descriptorSet.bindings, std::ranges::less{}, &vk::DescriptorSetLayoutBinding::binding);
+            }
+
+            std::ranges::sort(reflection.descriptorSets, std::ranges::less{}, &DescriptorSet::set);
+        }
+
+        {
+            uint32_t count = 0;
+            reflectCheck(spvReflectEnumeratePushConstantBlocks(&module, &count, nullptr), "vke::ShaderModule::reflect");
+            std::vector<SpvReflectBlockVariable*> blocks(count);
+            reflectCheck(spvReflectEnumeratePushConstantBlocks(&module, &count, blocks.data()), "vke::ShaderModule::reflect");
+
+            for(const SpvReflectBlockVariable* block : blocks)
+            {
+                reflection.pushConstantRanges.emplace_back(reflection.stage, block->offset, block->size);
+            }
+        }
+
+        if(reflection.stage == vk::ShaderStageFlagBits::eVertex)
+        {
+            uint32_t count = 0;
+            reflectCheck(spvReflectEnumerateInputVariables(&module, &count, nullptr), "vke::ShaderModule::reflect");
+            std::vector<SpvReflectInterfaceVariable*> inputs(count);
+            reflectCheck(spvReflectEnumerateInputVariables(&module, &count, inputs.data()), "vke::ShaderModule::reflect");
+
+            for(const SpvReflectInterfaceVariable* input : inputs)
+            {
+                if(input->decoration_flags & SPV_REFLECT_DECORATION_BUILT_IN)
+                    continue;
+
+                reflection.vertexAttributes.emplace_back(input->location, 0, static_cast<vk::Format>(input->format), 0);
+            }
+
+            std::ranges::sort(reflection.vertexAttributes, std::ranges::less{}, &vk::VertexInputAttributeDescription::location);
+
+            for(auto& attribute : reflection.vertexAttributes)
+            {
+                attribute.offset = reflection.vertexStride;
+                reflection.vertexStride += vk::blockSize(attribute.format);
+            }
+        }
+
+        return reflection;
+    }
+
+    std::vector<uint32_t> ShaderModule::readFile(const std::filesystem::path& path)
+    {
+        std::ifstream file{path, std::ios::ate | std::ios::binary};
+
+        if(!file.is_open())
+        {
+            throw std::runtime_error{std::format("vke::ShaderModule::readFile, Failed to open {}", path.string())};
+        }
+
+        size_t fileSize = static_cast<size_t>(file.tellg());
+        std::vector<uint32_t> code((fileSize + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(code.data()), fileSize);
+
+        return code;
+    }
+
+    vk::PipelineShaderStageCreateInfo ShaderModule::getStageCreateInfo() const noexcept
+    {
+        return vk::PipelineShaderStageCreateInfo{ {}, reflection.stage, *module, reflection.entryPoint.c_str() };
+    }
+
+    vk::VertexInputBindingDescription ShaderModule::getVertexBindingDescription(uint32_t binding, vk::VertexInputRate inputRate) const noexcept
+    {
+        return vk::VertexInputBindingDescription{ binding, reflection.vertexStride, inputRate };
+    }
+
+    std::vector<vk::VertexInputAttributeDescription> ShaderModule::getVertexAttributeDescriptions(uint32_t binding) const
+    {
+        auto attributes = reflection.vertexAttributes;
+        for(auto& attribute : attributes)
+        {
+            attribute.binding = binding;
+        }
+        return attributes;
+    }
+
+    LayoutCache::LayoutCache(const vk::raii::Device& device)
+        : p_device{&device} {}
+
+    vk::DescriptorSetLayout LayoutCache::getDescriptorSetLayout(std::span<const vk::DescriptorSetLayoutBinding> bindings_, 
+        vk::DescriptorSetLayoutCreateFlags flags)
+    {
+        std::vector<vk::DescriptorSetLayoutBinding> bindings{bindings_.begin(), bindings_.end()};
+        std::ranges::sort(bindings, std::ranges::less{}, &vk::DescriptorSetLayoutBinding::binding);
+
+        std::string key{};
+        appendKey(key, flags);
+        for(const auto& binding : bindings)
+        {
+            appendKey(key, binding.binding);
+            appendKey(key, binding.descriptorType);
+            appendKey(key, binding.descriptorCount);
+            appendKey(key, binding.stageFlags);
+            if(binding.pImmutableSamplers)
+            {
+                for(uint32_t index = 0; index < binding.descriptorCount; index++)
+                {
+                    appendKey(key, binding.pImmutableSamplers[index]);
+                }
+            }
+        }
+
+        std::lock_guard lock{mutex};
+
+        auto it = descriptorSetLayouts.find(key);
+        if(it == descriptorSetLayouts.end())
+        {
+            it = descriptorSetLayouts.emplace(std::move(key), 
+                vk::raii::DescriptorSetLayout{*p_device, vk::DescriptorSetLayoutCreateInfo{ flags, bindings }}).first;
+        }
+
+        return *it->second;
+    }
+
+    vk::PipelineLayout LayoutCache::getPipelineLayout(std::span<const vk::DescriptorSetLayout> setLayouts, 
+        std::span<const vk::PushConstantRange> pushConstantRanges)
+    {
+        std::string key{};
+        appendKey(key, static_cast<uint32_t>(setLayouts.size()));
+        for(const auto& setLayout : setLayouts)
+        {
+            appendKey(key, setLayout);
+        }
+        for(const auto& range : pushConstantRanges)
+        {
+            appendKey(key, range.stageFlags);
+            appendKey(key, range.offset);
+            appendKey(key, range.size);
+        }
+
+        std::lock_guard lock{mutex};
+
+        auto it = pipelineLayouts.find(key);
+        if(it == pipelineLayouts.end())
+        {
+            vk::PipelineLayoutCreateInfo createInfo{};
+            createInfo.setSetLayoutCount(setLayouts.size());
+            createInfo.setPSetLayouts(setLayouts.data());
+            createInfo.setPushConstantRangeCount(pushConstantRanges.size());
+            createInfo.setPPushConstantRanges(pushConstantRanges.data());
+
+            it = pipelineLayouts.emplace(std::move(key), vk::raii::PipelineLayout{*p_device, createInfo}).first;
+        }
+
+        return *it->second;
+    }
+
+    LayoutCache::PipelineLayout LayoutCache::getPipelineLayout(std::span<const ShaderModule* const> shaderModules)
+    {
+        std::map<uint32_t, std::map<uint32_t, vk::DescriptorSetLayoutBinding>> sets{};
+        std::vector<vk::PushConstantRange> pushConstantRanges{};
+
+        for(const ShaderModule* shaderModule : shaderModules)
+        {
+            const auto& reflection = shaderModule->getReflection();
+
+            for(const auto& descriptorSet : reflection.descriptorSets)
+            {
+                auto& set = sets[descriptorSet.set];
+                for(const auto& binding : descriptorSet.bindings)
+                {
+                    auto [it, inserted] = set.try_emplace(binding.binding, binding);
+                    if(!inserted)
+                    {
+                        it->second.stageFlags |= binding.stageFlags;
+                        it->second.descriptorCount = std::max(it->second.descriptorCount, binding.descriptorCount);
+                    }
+                }
+            }
+
+            if(!reflection.pushConstantRanges.empty())
+            {
+                uint32_t begin = std::ranges::min(reflection.pushConstantRanges | std::ranges::views::transform(&vk::PushConstantRange::offset));
+                uint32_t end = std::ranges::max(reflection.pushConstantRanges | std::ranges::views::transform(
+                    [](const vk::PushConstantRange& range) { return range.offset + range.size; }));
+
+                auto it = std::ranges::find_if(pushConstantRanges, [&](const vk::PushConstantRange& range)
+                    { return range.offset == begin && range.size == end - begin; });
+
+                if(it != pushConstantRanges.end())
+                    it->stageFlags |= reflection.stage;
+                else
+                    pushConstantRanges.emplace_back(reflection.stage, begin, end - begin);
+            }
+        }
+
+        PipelineLayout layout{};
+
+        uint32_t setCount = sets.empty() ? 0 : sets.rbegin()->first + 1;
+        layout.setLayouts.reserve(setCount);
+
+        for(uint32_t setIndex = 0; setIndex < setCount; setIndex++)
+        {
+            std::vector<vk::DescriptorSetLayoutBinding> bindings{};
+            if(auto it = sets.find(setIndex); it != sets.end())
+            {
+                bindings = std::ranges::to<std::vector<vk::DescriptorSetLayoutBinding>>(it->second | std::ranges::views::values);
+            }
+
+            layout.setLayouts.emplace_back(getDescriptorSetLayout(bindings));
+        }
+
+        layout.pipelineLayout = getPipelineLayout(layout.setLayouts, pushConstantRanges);
+
+        return layout;
+    }
+
+    LayoutCache::PipelineLayout LayoutCache::getPipelineLayout(std::initializer_list<const ShaderModule*> shaderModules)
+    {
+        return getPipelineLayout(std::span<const ShaderModule* const>{shaderModules.begin(), shaderModules.size()});
+    }
+
+    size_t LayoutCache::getDescriptorSetLayoutCount() const
+    {
+        std::lock_guard lock{mutex};
+        return descriptorSetLayouts.size();
+    }
+
+    size_t LayoutCache::getPipelineLayoutCount() const
+    {
+        std::lock_guard lock{mutex};
+        return pipelineLayouts.size();
+    }
+}
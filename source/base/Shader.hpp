@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+namespace vke{
+
+    class ShaderModule
+    {
+    public:
+        struct DescriptorSet
+        {
+            uint32_t set = 0;
+            std::vector<vk::DescriptorSetLayoutBinding> bindings;
+        };
+
+        struct Reflection
+        {
+            vk::ShaderStageFlagBits stage = vk::ShaderStageFlagBits::eVertex;
+            std::string entryPoint = "main";
+            std::vector<DescriptorSet> descriptorSets;
+            std::vector<vk::PushConstantRange> pushConstantRanges;
+            std::vector<vk::VertexInputAttributeDescription> vertexAttributes;
+            uint32_t vertexStride = 0;
+        };
+
+        struct Embedded
+        {
+            std::span<const uint32_t> code;
+            Reflection (*reflection)() = nullptr;
+        };
+
+        ShaderModule(const vk::raii::Device& device, std::span<const uint32_t> code);
+        ShaderModule(const vk::raii::Device& device, std::span<const uint32_t> code, Reflection reflection);
+        ShaderModule(const vk::raii::Device& device, const std::filesystem::path& path);
+        ShaderModule(const vk::raii::Device& device, const Embedded& embedded);
+
+        ShaderModule(ShaderModule&&) noexcept = default;
+        ShaderModule& operator=(ShaderModule&&) noexcept = default;
+
+        static Reflection reflect(std::span<const uint32_t> code);
+        static std::vector<uint32_t> readFile(const std::filesystem::path& path);
+
+        inline const Reflection& getReflection() const noexcept { return reflection; }
+
+        vk::PipelineShaderStageCreateInfo getStageCreateInfo() const noexcept;
+        vk::VertexInputBindingDescription getVertexBindingDescription(uint32_t binding = 0, 
+            vk::VertexInputRate inputRate = vk::VertexInputRate::eVertex) const noexcept;
+        std::vector<vk::VertexInputAttributeDescription> getVertexAttributeDescriptions(uint32_t binding = 0) const;
+
+        inline operator const vk::raii::ShaderModule & () const & noexcept { return module; }
+        inline operator vk::ShaderModule () const & noexcept { return *module; }
+        inline const auto* operator->() const & noexcept { return &module; }
+
+    private:
+        Reflection reflection;
+        vk::raii::ShaderModule module{ nullptr };
+    };
+
+    class LayoutCache
+    {
+    public:
+        struct PipelineLayout
+        {
+            std::vector<vk::DescriptorSetLayout> setLayouts;
+            vk::PipelineLayout pipelineLayout{};
+        };
+
+        explicit LayoutCache(const vk::raii::Device& device);
+
+        LayoutCache(const LayoutCache&) = delete;
+        LayoutCache& operator=(const LayoutCache&) = delete;
+
+        vk::DescriptorSetLayout getDescriptorSetLayout(std::span<const vk::DescriptorSetLayoutBinding> bindings, 
+            vk::DescriptorSetLayoutCreateFlags flags = {});
+        vk::PipelineLayout getPipelineLayout(std::span<const vk::DescriptorSetLayout> setLayouts, 
+            std::span<const vk::PushConstantRange> pushConstantRanges);
+        PipelineLayout getPipelineLayout(std::span<const ShaderModule* const> shaderModules);
+        PipelineLayout getPipelineLayout(std::initializer_list<const ShaderModule*> shaderModules);
+
+        size_t getDescriptorSetLayoutCount() const;
+        size_t getPipelineLayoutCount() const;
+
+    private:
+        const vk::raii::Device* p_device = nullptr;
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, vk::raii::DescriptorSetLayout> descriptorSetLayouts;
+        std::unordered_map<std::string, vk::raii::PipelineLayout> pipelineLayouts;
+    };
+
+}
@@ -0,0 +1,280 @@
+#include "Statistics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace vke{
+    namespace{
+        constexpr size_t metric_count = static_cast<size_t>(FrameStatistics::Metric::eCount);
+
+        std::chrono::nanoseconds getSortedPercentile(std::span<const int64_t> sorted, double percentile)
+        {
+            if(sorted.empty())
+                return std::chrono::nanoseconds{0};
+
+            size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+            return std::chrono::nanoseconds{ sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1] };
+        }
+    }
+
+    uint32_t LatencyHistogram::getIndex(uint64_t value) noexcept
+    {
+        if(value < subBucketCount)
+            return static_cast<uint32_t>(value);
+
+        uint32_t bucket = static_cast<uint32_t>(std::bit_width(value)) - subBucketBits;
+        uint32_t subBucket = static_cast<uint32_t>(value >> bucket);
+        return subBucketCount + (bucket - 1) * subBucketHalfCount + (subBucket - subBucketHalfCount);
+    }
+
+    uint64_t LatencyHistogram::getHighestEquivalentValue(uint32_t index) noexcept
+    {
+        if(index < subBucketCount)
+            return index;
+
+        uint32_t bucket = (index - subBucketCount) / subBucketHalfCount + 1;
+        uint64_t subBucket = (index - subBucketCount) % subBucketHalfCount + subBucketHalfCount;
+        return ((subBucket + 1) << bucket) - 1;
+    }
+
+    void LatencyHistogram::record(uint64_t value) noexcept
+    {
+        value = std::min(value, maxTrackableValue);
+        counts[getIndex(value)]++;
+        count++;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other) noexcept
+    {
+        for(uint32_t i = 0; i < bucketCount; i++)
+        {
+            counts[i] += other.counts[i];
+        }
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    void LatencyHistogram::reset() noexcept
+    {
+        *this = LatencyHistogram{};
+    }
+
+    uint64_t LatencyHistogram::getPercentile(double percentile) const noexcept
+    {
+        if(!count)
+            return 0;
+
+        uint64_t target = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(count)));
+        target = std::max<uint64_t>(target, 1);
+
+        uint64_t cumulative = 0;
+        for(uint32_t i = 0; i < bucketCount; i++)
+        {
+            cumulative += counts[i];
+            if(cumulative >= target)
+                return std::clamp(getHighestEquivalentValue(i), min, max);
+        }
+        return max;
+    }
+
+    FrameStatistics::FrameStatistics(const CreateInfo& createInfo_)
+        : createInfo{createInfo_}, windowSize{std::max<size_t>(createInfo_.windowSize, 1)}
+    {
+        for(MetricState& metric : metrics)
+        {
+            metric.window.reserve(windowSize);
+        }
+        droppedWindow.resize(windowSize);
+    }
+
+    void FrameStatistics::beginFrame()
+    {
+        std::lock_guard lock{mutex};
+        frameBegin = std::chrono::steady_clock::now();
+    }
+
+    void FrameStatistics::endFrame()
+    {
+        std::lock_guard lock{mutex};
+        if(frameBegin == std::chrono::steady_clock::time_point{})
+            return;
+
+        recordLocked(Metric::eCpuFrameTime, std::chrono::steady_clock::now() - frameBegin);
+        frameBegin = {};
+        frameCount++;
+        droppedWindow[frameCount % windowSize] = 0;
+    }
+
+    void FrameStatistics::record(Metric metric, std::chrono::nanoseconds duration)
+    {
+        std::lock_guard lock{mutex};
+        recordLocked(metric, duration);
+    }
+
+    void FrameStatistics::recordDroppedFrames(uint64_t count)
+    {
+        std::lock_guard lock{mutex};
+        recordDroppedLocked(count);
+    }
+
+    void FrameStatistics::collect(const Swapchain& swapchain)
+    {
+        std::vector<Swapchain::FrameLatency> latencies = swapchain.getFrameLatencies();
+        std::ranges::sort(latencies, {}, &Swapchain::FrameLatency::presentId);
+        std::chrono::nanoseconds frameBudget = createInfo.frameBudget();
+
+        std::lock_guard lock{mutex};
+        for(const Swapchain::FrameLatency& latency : latencies)
+        {
+            if(latency.presentId <= lastPresentId || latency.presentCompleted == std::chrono::steady_clock::time_point{})
+                continue;
+
+            recordLocked(Metric::ePresentWait, latency.getPresentLatency());
+
+            if(frameBudget.count() > 0 && lastPresentCompleted != std::chrono::steady_clock::time_point{})
+            {
+                auto interval = latency.presentCompleted - lastPresentCompleted;
+                auto missed = (interval + frameBudget / 2) / frameBudget;
+                if(missed > 1)
+                    recordDroppedLocked(static_cast<uint64_t>(missed - 1));
+            }
+
+            lastPresentId = latency.presentId;
+            lastPresentCompleted = latency.presentCompleted;
+        }
+    }
+
+    void FrameStatistics::collect(const GpuProfiler& profiler)
+    {
+        std::vector<GpuProfiler::Frame> frames = profiler.getFrames();
+
+        std::lock_guard lock{mutex};
+        for(const GpuProfiler::Frame& frame : frames)
+        {
+            if(frame.frameNumber <= lastGpuFrameNumber)
+                continue;
+
+            recordLocked(Metric::eGpuFrameTime, std::chrono::nanoseconds{ frame.end - frame.begin });
+            lastGpuFrameNumber = frame.frameNumber;
+        }
+    }
+
+    FrameStatistics::Percentiles FrameStatistics::getPercentiles(Metric metric) const
+    {
+        std::lock_guard lock{mutex};
+        const LatencyHistogram& histogram = metrics[static_cast<size_t>(metric)].histogram;
+        return Percentiles{ 
+            std::chrono::nanoseconds{ histogram.getPercentile(50.0) },
+            std::chrono::nanoseconds{ histogram.getPercentile(95.0) },
+            std::chrono::nanoseconds{ histogram.getPercentile(99.0) },
+            std::chrono::nanoseconds{ histogram.getPercentile(99.9) } };
+    }
+
+    FrameStatistics::Percentiles FrameStatistics::getWindowPercentiles(Metric metric) const
+    {
+        std::lock_guard lock{mutex};
+        return getWindowPercentilesLocked(metric);
+    }
+
+    std::vector<std::chrono::nanoseconds> FrameStatistics::getWindow(Metric metric) const
+    {
+        std::lock_guard lock{mutex};
+        const MetricState& state = metrics[static_cast<size_t>(metric)];
+
+        std::vector<std::chrono::nanoseconds> window{};
+        window.reserve(state.window.size());
+        for(size_t i = 0; i < state.window.size(); i++)
+        {
+            size_t index = state.window.size() < windowSize ? i : (state.windowNext + i) % windowSize;
+            window.emplace_back(state.window[index]);
+        }
+        return window;
+    }
+
+    FrameStatistics::Summary FrameStatistics::getSummary() const
+    {
+        Summary summary{};
+        for(size_t i = 0; i < metric_count; i++)
+        {
+            summary.metrics[i] = getPercentiles(static_cast<Metric>(i));
+        }
+
+        std::lock_guard lock{mutex};
+        summary.frameCount = frameCount;
+        summary.droppedFrameCount = droppedFrameCount;
+        return summary;
+    }
+
+    FrameStatistics::Summary FrameStatistics::getWindowSummary() const
+    {
+        std::lock_guard lock{mutex};
+
+        Summary summary{};
+        summary.frameCount = std::min<uint64_t>(frameCount, windowSize);
+        for(uint64_t dropped : droppedWindow)
+        {
+            summary.droppedFrameCount += dropped;
+        }
+        for(size_t i = 0; i < metric_count; i++)
+        {
+            summary.metrics[i] = getWindowPercentilesLocked(static_cast<Metric>(i));
+        }
+        return summary;
+    }
+
+    LatencyHistogram FrameStatistics::getHistogram(Metric metric) const
+    {
+        std::lock_guard lock{mutex};
+        return metrics[static_cast<size_t>(metric)].histogram;
+    }
+
+    void FrameStatistics::reset()
+    {
+        std::lock_guard lock{mutex};
+        for(MetricState& metric : metrics)
+        {
+            metric.histogram.reset();
+            metric.window.clear();
+            metric.windowNext = 0;
+        }
+        std::ranges::fill(droppedWindow, 0);
+        frameCount = 0;
+        droppedFrameCount = 0;
+    }
+
+    void FrameStatistics::recordLocked(Metric metric, std::chrono::nanoseconds duration)
+    {
+        MetricState& state = metrics[static_cast<size_t>(metric)];
+        int64_t value = std::max<int64_t>(duration.count(), 0);
+
+        state.histogram.record(static_cast<uint64_t>(value));
+        if(state.window.size() < windowSize)
+            state.window.push_back(value);
+        else
+            state.window[state.windowNext] = value;
+        state.windowNext = (state.windowNext + 1) % windowSize;
+    }
+
+    void FrameStatistics::recordDroppedLocked(uint64_t count)
+    {
+        droppedFrameCount += count;
+        droppedWindow[frameCount % windowSize] += count;
+    }
+
+    FrameStatistics::Percentiles FrameStatistics::getWindowPercentilesLocked(Metric metric) const
+    {
+        std::vector<int64_t> sorted = metrics[static_cast<size_t>(metric)].window;
+        std::ranges::sort(sorted);
+        return Percentiles{ 
+            getSortedPercentile(sorted, 50.0), 
+            getSortedPercentile(sorted, 95.0), 
+            getSortedPercentile(sorted, 99.0), 
+            getSortedPercentile(sorted, 99.9) };
+    }
+}
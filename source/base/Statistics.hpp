@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Profiler.hpp"
+#include "Resources.hpp"
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace vke{
+
+    class LatencyHistogram
+    {
+    public:
+        static constexpr uint32_t subBucketBits = 7;
+        static constexpr uint32_t maxValueBits = 44;
+        static constexpr uint64_t maxTrackableValue = (uint64_t{1} << maxValueBits) - 1;
+
+        void record(uint64_t value) noexcept;
+        void merge(const LatencyHistogram& other) noexcept;
+        void reset() noexcept;
+
+        uint64_t getPercentile(double percentile) const noexcept;
+        inline uint64_t getCount() const noexcept { return count; }
+        inline uint64_t getMin() const noexcept { return count ? min : 0; }
+        inline uint64_t getMax() const noexcept { return max; }
+        inline double getMean() const noexcept { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+
+    private:
+        static constexpr uint32_t subBucketCount = 1 << subBucketBits;
+        static constexpr uint32_t subBucketHalfCount = subBucketCount / 2;
+        static constexpr uint32_t bucketCount = subBucketCount + (maxValueBits - subBucketBits) * subBucketHalfCount;
+
+        std::array<uint64_t, bucketCount> counts{};
+        uint64_t count = 0;
+        uint64_t min = UINT64_MAX;
+        uint64_t max = 0;
+        uint64_t sum = 0;
+
+        static uint32_t getIndex(uint64_t value) noexcept;
+        static uint64_t getHighestEquivalentValue(uint32_t index) noexcept;
+    };
+
+    class FrameStatistics
+    {
+    public:
+        enum class Metric : uint8_t
+        {
+            eCpuFrameTime,
+            eGpuFrameTime,
+            eAcquireWait,
+            ePresentWait,
+            eCount
+        };
+
+        struct CreateInfo
+        {
+            size_t windowSize = 240;
+            Getter<std::chrono::nanoseconds> frameBudget{std::chrono::nanoseconds{0}};
+        };
+
+        struct Percentiles
+        {
+            std::chrono::nanoseconds p50{0};
+            std::chrono::nanoseconds p95{0};
+            std::chrono::nanoseconds p99{0};
+            std::chrono::nanoseconds p999{0};
+        };
+
+        struct Summary
+        {
+            uint64_t frameCount = 0;
+            uint64_t droppedFrameCount = 0;
+            std::array<Percentiles, static_cast<size_t>(Metric::eCount)> metrics{};
+        };
+
+        class ScopedTimer
+        {
+        public:
+            ScopedTimer(FrameStatistics* statistics, Metric metric) noexcept 
+                : p_statistics{statistics}, metric{metric}, begin{std::chrono::steady_clock::now()} {}
+            ~ScopedTimer() { p_statistics->record(metric, std::chrono::steady_clock::now() - begin); }
+
+            ScopedTimer(const ScopedTimer&) = delete;
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        private:
+            FrameStatistics* p_statistics = nullptr;
+            Metric metric;
+            std::chrono::steady_clock::time_point begin;
+        };
+
+        explicit FrameStatistics(const CreateInfo& createInfo);
+
+        FrameStatistics(const FrameStatistics&) = delete;
+        FrameStatistics& operator=(const FrameStatistics&) = delete;
+
+        void beginFrame();
+        void endFrame();
+
+        void record(Metric metric, std::chrono::nanoseconds duration);
+        void recordDroppedFrames(uint64_t count = 1);
+        [[nodiscard]] ScopedTimer measure(Metric metric) { return ScopedTimer{this, metric}; }
+
+        void collect(const Swapchain& swapchain);
+        void collect(const GpuProfiler& profiler);
+
+        Percentiles getPercentiles(Metric metric) const;
+        Percentiles getWindowPercentiles(Metric metric) const;
+        std::vector<std::chrono::nanoseconds> getWindow(Metric metric) const;
+        Summary getSummary() const;
+        Summary getWindowSummary() const;
+        LatencyHistogram getHistogram(Metric metric) const;
+        void reset();
+
+        inline uint64_t getFrameCount() const noexcept { std::lock_guard lock{mutex}; return frameCount; }
+        inline uint64_t getDroppedFrameCount() const noexcept { std::lock_guard lock{mutex}; return droppedFrameCount; }
+
+    private:
+        struct MetricState
+        {
+            LatencyHistogram histogram;
+            std::vector<int64_t> window;
+            size_t windowNext = 0;
+        };
+
+        CreateInfo createInfo;
+        size_t windowSize = 0;
+
+        mutable std::mutex mutex;
+        std::array<MetricState, static_cast<size_t>(Metric::eCount)> metrics;
+        std::vector<uint64_t> droppedWindow;
+        uint64_t frameCount = 0;
+        uint64_t droppedFrameCount = 0;
+        std::chrono::steady_clock::time_point frameBegin{};
+
+        uint64_t lastPresentId = 0;
+        std::chrono::steady_clock::time_point lastPresentCompleted{};
+        uint64_t lastGpuFrameNumber = 0;
+
+        void recordLocked(Metric metric, std::chrono::nanoseconds duration);
+        void recordDroppedLocked(uint64_t count);
+        Percentiles getWindowPercentilesLocked(Metric metric) const;
+    };
+
+}
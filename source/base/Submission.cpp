@@ -0,0 +1,186 @@
+#include "Submission.hpp"
+#include "Instrumentation.hpp"
+
+#include <bit>
+
+namespace vke{
+
+    SubmissionQueue::SubmissionQueue(const vk::raii::Device& device, const DeviceQueue& queue, const CreateInfo& createInfo)
+        : p_queue{&queue}, maxBatchSize{std::max<size_t>(createInfo.maxBatchSize, 1)}
+    {
+        size_t capacity = std::bit_ceil(std::max<size_t>(createInfo.capacity, 2));
+        mask = capacity - 1;
+        cells = std::make_unique<Cell[]>(capacity);
+        for(size_t i = 0; i < capacity; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        thread = std::jthread{[this]{ run(); }};
+    }
+
+    SubmissionQueue::SubmissionQueue(const Device& device, const DeviceQueue& queue, const CreateInfo& createInfo)
+        : SubmissionQueue{static_cast<const vk::raii::Device&>(device), queue, createInfo}
+    {
+        if(!device.getEnabledFeatures().synchronization2)
+            throw std::runtime_error("vke::SubmissionQueue requires the synchronization2 feature");
+    }
+
+    SubmissionQueue::~SubmissionQueue()
+    {
+        stopping.store(true, std::memory_order_release);
+        wakeCount.fetch_add(1, std::memory_order_release);
+        wakeCount.notify_one();
+        thread.join();
+    }
+
+    bool SubmissionQueue::trySubmit(Submission&& submission)
+    {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+
+        while(true)
+        {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if(difference == 0)
+            {
+                if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if(difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->submission = std::move(submission);
+        cell->sequence.store(position + 1, std::memory_order_release);
+
+        wakeCount.fetch_add(1, std::memory_order_release);
+        wakeCount.notify_one();
+        return true;
+    }
+
+    void SubmissionQueue::submit(Submission&& submission)
+    {
+        while(!trySubmit(std::move(submission)))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void SubmissionQueue::flush()
+    {
+        size_t target = enqueuePosition.load(std::memory_order_acquire);
+
+        size_t submitted = submittedPosition.load(std::memory_order_acquire);
+        while(submitted < target)
+        {
+            submittedPosition.wait(submitted, std::memory_order_acquire);
+            submitted = submittedPosition.load(std::memory_order_acquire);
+        }
+
+        vk::detail::resultCheck(lastResult.exchange(vk::Result::eSuccess), "vke::SubmissionQueue::flush");
+    }
+
+    SubmissionQueue::Statistics SubmissionQueue::getStatistics() const noexcept
+    {
+        return Statistics{
+            .submissionCount = submissionCount.load(std::memory_order_relaxed),
+            .batchCount = batchCount.load(std::memory_order_relaxed),
+            .submitCallCount = submitCallCount.load(std::memory_order_relaxed),
+            .maxBatchSize = maxBatchSizeSeen.load(std::memory_order_relaxed),
+            .queueDepth = enqueuePosition.load(std::memory_order_relaxed) - dequeuePosition.load(std::memory_order_relaxed),
+            .maxQueueDepth = maxQueueDepth.load(std::memory_order_relaxed) };
+    }
+
+    void SubmissionQueue::run()
+    {
+        std::vector<Submission> batch{};
+        batch.reserve(maxBatchSize);
+
+        while(true)
+        {
+            uint64_t wake = wakeCount.load(std::memory_order_acquire);
+
+            size_t position = dequeuePosition.load(std::memory_order_relaxed);
+            size_t depth = enqueuePosition.load(std::memory_order_relaxed) - position;
+            while(batch.size() < maxBatchSize)
+            {
+                Cell& cell = cells[position & mask];
+                if(cell.sequence.load(std::memory_order_acquire) != position + 1)
+                    break;
+
+                batch.push_back(std::move(cell.submission));
+                cell.sequence.store(position + mask + 1, std::memory_order_release);
+                ++position;
+            }
+            dequeuePosition.store(position, std::memory_order_relaxed);
+
+            if(batch.empty())
+            {
+                if(stopping.load(std::memory_order_acquire))
+                    return;
+                wakeCount.wait(wake, std::memory_order_acquire);
+                continue;
+            }
+
+            submitBatch(batch);
+
+            submissionCount.fetch_add(batch.size(), std::memory_order_relaxed);
+            batchCount.fetch_add(1, std::memory_order_relaxed);
+            if(batch.size() > maxBatchSizeSeen.load(std::memory_order_relaxed))
+                maxBatchSizeSeen.store(batch.size(), std::memory_order_relaxed);
+            if(depth > maxQueueDepth.load(std::memory_order_relaxed))
+                maxQueueDepth.store(depth, std::memory_order_relaxed);
+
+            batch.clear();
+            submittedPosition.store(position, std::memory_order_release);
+            submittedPosition.notify_all();
+        }
+    }
+
+    void SubmissionQueue::submitBatch(std::span<const Submission> batch)
+    {
+        VKE_ZONE("SubmissionQueue::submitBatch");
+        VKE_COUNTER("SubmissionQueue batch size", batch.size());
+        std::vector<vk::SubmitInfo2> submitInfos{};
+        submitInfos.reserve(batch.size());
+
+        auto submit = [&](vk::Fence fence)
+        {
+            if(submitInfos.empty() && !fence)
+                return;
+
+            try
+            {
+                p_queue->submit2(submitInfos, fence);
+            }
+            catch(const vk::SystemError& error)
+            {
+                lastResult.store(static_cast<vk::Result>(error.code().value()));
+            }
+            submitCallCount.fetch_add(1, std::memory_order_relaxed);
+            submitInfos.clear();
+        };
+
+        for(const Submission& submission : batch)
+        {
+            submitInfos.emplace_back(vk::SubmitInfo2{}
+                .setWaitSemaphoreInfos(submission.waitSemaphores)
+                .setCommandBufferInfos(submission.commandBuffers)
+                .setSignalSemaphoreInfos(submission.signalSemaphores));
+
+            if(submission.fence)
+                submit(submission.fence);
+        }
+        submit({});
+    }
+}
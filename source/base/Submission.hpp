@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace vke{
+
+    class SubmissionQueue
+    {
+    public:
+        struct Submission
+        {
+            std::vector<vk::SemaphoreSubmitInfo> waitSemaphores;
+            std::vector<vk::CommandBufferSubmitInfo> commandBuffers;
+            std::vector<vk::SemaphoreSubmitInfo> signalSemaphores;
+            vk::Fence fence{};
+        };
+
+        struct Statistics
+        {
+            uint64_t submissionCount = 0;
+            uint64_t batchCount = 0;
+            uint64_t submitCallCount = 0;
+            size_t maxBatchSize = 0;
+            size_t queueDepth = 0;
+            size_t maxQueueDepth = 0;
+
+            inline double getAverageBatchSize() const noexcept { return batchCount ? static_cast<double>(submissionCount) / batchCount : 0.0; }
+        };
+
+        struct CreateInfo
+        {
+            size_t capacity = 1024;
+            size_t maxBatchSize = 64;
+        };
+
+        SubmissionQueue(const vk::raii::Device& device, const DeviceQueue& queue, const CreateInfo& createInfo);
+        SubmissionQueue(const Device& device, const DeviceQueue& queue, const CreateInfo& createInfo);
+        ~SubmissionQueue();
+
+        SubmissionQueue(const SubmissionQueue&) = delete;
+        SubmissionQueue& operator=(const SubmissionQueue&) = delete;
+
+        bool trySubmit(Submission&& submission);
+        void submit(Submission&& submission);
+        void flush();
+
+        inline const DeviceQueue& getQueue() const noexcept { return *p_queue; }
+        Statistics getStatistics() const noexcept;
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence{0};
+            Submission submission{};
+        };
+
+        const DeviceQueue* p_queue = nullptr;
+        size_t maxBatchSize = 0;
+        size_t mask = 0;
+        std::unique_ptr<Cell[]> cells;
+
+        alignas(64) std::atomic<size_t> enqueuePosition{0};
+        alignas(64) std::atomic<size_t> dequeuePosition{0};
+        alignas(64) std::atomic<size_t> submittedPosition{0};
+        std::atomic<uint64_t> wakeCount{0};
+        std::atomic<bool> stopping{false};
+        std::atomic<vk::Result> lastResult{vk::Result::eSuccess};
+
+        std::atomic<uint64_t> submissionCount{0};
+        std::atomic<uint64_t> batchCount{0};
+        std::atomic<uint64_t> submitCallCount{0};
+        std::atomic<size_t> maxBatchSizeSeen{0};
+        std::atomic<size_t> maxQueueDepth{0};
+
+        std::jthread thread;
+
+        void run();
+        void submitBatch(std::span<const Submission> batch);
+    };
+
+}
@@ -0,0 +1,441 @@
+#include "Synchronization.hpp"
+#include "Base.hpp"
+
+namespace vke{
+    DeletionQueue* default_deletion_queue = nullptr;
+    CompletionReactor* default_completion_reactor = nullptr;
+
+    TimelineSemaphore::TimelineSemaphore(const vk::raii::Device& device, uint64_t initialValue)
+        : p_device{&device}
+    {
+        vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo> createInfo{ {}, { vk::SemaphoreType::eTimeline, initialValue } };
+        semaphore = vk::raii::Semaphore{ device, createInfo.get<vk::SemaphoreCreateInfo>() };
+    }
+
+    void TimelineSemaphore::signal(uint64_t value) const
+    {
+        p_device->signalSemaphore(vk::SemaphoreSignalInfo{ *semaphore, value });
+    }
+
+    bool TimelineSemaphore::wait(uint64_t value, uint64_t timeout) const
+    {
+        vk::Semaphore waitSemaphore = *semaphore;
+        return p_device->waitSemaphores(vk::SemaphoreWaitInfo{ {}, waitSemaphore, value }, timeout) == vk::Result::eSuccess;
+    }
+
+    uint64_t TimelineSemaphore::getValue() const
+    {
+        return semaphore.getCounterValue();
+    }
+
+    DeletionQueue::DeletionQueue(const Device& device)
+    {
+        if(!device.getEnabledFeatures().timelineSemaphore)
+            throw std::runtime_error("vke::DeletionQueue requires the timelineSemaphore feature");
+
+        for(uint32_t queueFamilyIndex = 0; queueFamilyIndex < device.getDeviceQueueInfos().size(); queueFamilyIndex++)
+        {
+            for(const DeviceQueue& queue : device.getDeviceQueues(queueFamilyIndex))
+            {
+                queues.push_back(&queue);
+            }
+        }
+        completedValues.resize(queues.size(), 0);
+    }
+
+    DeletionQueue::~DeletionQueue()
+    {
+        try
+        {
+            flush();
+        }
+        catch(...)
+        {
+        }
+
+        std::lock_guard lock{mutex};
+        for(Epoch& epoch : epochs)
+        {
+            for(auto& deleter : epoch.deleters)
+            {
+                deleter();
+            }
+        }
+        epochs.clear();
+        entryCount = 0;
+    }
+
+    void DeletionQueue::enqueue(std::move_only_function<void()> deleter)
+    {
+        std::vector<uint64_t> values = std::ranges::to<std::vector<uint64_t>>(queues 
+            | std::ranges::views::transform([](const DeviceQueue* queue){ return queue->getSubmittedValue(); }));
+
+        {
+            std::lock_guard lock{mutex};
+            if(!isCompleteUnlocked(values))
+            {
+                if(epochs.empty() || epochs.back().values != values)
+                    epochs.push_back(Epoch{ std::move(values), {} });
+                epochs.back().deleters.push_back(std::move(deleter));
+                ++entryCount;
+                return;
+            }
+        }
+
+        deleter();
+    }
+
+    void DeletionQueue::collect()
+    {
+        std::vector<uint64_t> values = std::ranges::to<std::vector<uint64_t>>(queues 
+            | std::ranges::views::transform([](const DeviceQueue* queue){ return queue->getCompletedValue(); }));
+
+        std::vector<std::move_only_function<void()>> ready{};
+        {
+            std::lock_guard lock{mutex};
+            for(auto&& [completedValue, value] : std::views::zip(completedValues, values))
+            {
+                completedValue = std::max(completedValue, value);
+            }
+
+            while(!epochs.empty() && isCompleteUnlocked(epochs.front().values))
+            {
+                std::ranges::move(epochs.front().deleters, std::back_inserter(ready));
+                epochs.pop_front();
+            }
+            entryCount -= ready.size();
+        }
+
+        for(auto& deleter : ready)
+        {
+            deleter();
+        }
+    }
+
+    void DeletionQueue::flush()
+    {
+        for(const DeviceQueue* queue : queues)
+        {
+            queue->wait(queue->getSubmittedValue());
+        }
+        collect();
+    }
+
+    size_t DeletionQueue::size() const
+    {
+        std::lock_guard lock{mutex};
+        return entryCount;
+    }
+
+    bool DeletionQueue::isCompleteUnlocked(std::span<const uint64_t> values) const noexcept
+    {
+        return std::ranges::equal(values, completedValues, std::ranges::less_equal{});
+    }
+
+    DeletionQueue* getDefaultDeletionQueue() noexcept
+    {
+        return default_deletion_queue;
+    }
+
+    DeletionQueue* setDefaultDeletionQueue(DeletionQueue* queue) noexcept
+    {
+        default_deletion_queue = queue;
+        return default_deletion_queue;
+    }
+
+    CompletionReactor::CompletionReactor(const vk::raii::Device& device, const CreateInfo& createInfo)
+        : p_device{&device}, executor{createInfo.executor}, wakeSemaphore{device}
+    {
+        thread = std::jthread{[this]{ run(); }};
+    }
+
+    CompletionReactor::~CompletionReactor()
+    {
+        {
+            std::lock_guard lock{mutex};
+            stopping = true;
+        }
+        wake();
+        thread.join();
+    }
+
+    void CompletionReactor::watch(vk::Fence fence, Callback callback)
+    {
+        std::lock_guard lock{mutex};
+        auto it = fenceThreads.emplace(fenceThreads.end());
+        *it = std::jthread{[this, it, wait = FenceWait{fence, std::move(callback)}]() mutable { waitFence(it, std::move(wait)); }};
+        ++outstanding;
+    }
+
+    void CompletionReactor::watch(vk::Semaphore semaphore, uint64_t value, Callback callback)
+    {
+        {
+            std::lock_guard lock{mutex};
+            pendingSemaphores.emplace_back(semaphore, value, std::move(callback));
+            ++outstanding;
+        }
+        wake();
+    }
+
+    bool CompletionReactor::isComplete(vk::Fence fence, vk::Semaphore semaphore, uint64_t value) const
+    {
+        const auto& dispatcher = *p_device->getDispatcher();
+        if(fence)
+            return static_cast<vk::Result>(dispatcher.vkGetFenceStatus(static_cast<VkDevice>(**p_device), static_cast<VkFence>(fence))) == vk::Result::eSuccess;
+
+        uint64_t counter = 0;
+        dispatcher.vkGetSemaphoreCounterValue(static_cast<VkDevice>(**p_device), static_cast<VkSemaphore>(semaphore), &counter);
+        return counter >= value;
+    }
+
+    size_t CompletionReactor::size() const
+    {
+        std::lock_guard lock{mutex};
+        return outstanding;
+    }
+
+    void CompletionReactor::wake()
+    {
+        std::lock_guard lock{mutex};
+        wakeSemaphore.signal(++wakeValue);
+    }
+
+    void CompletionReactor::dispatch(Callback&& callback)
+    {
+        if(executor)
+            executor(std::move(callback));
+        else
+            callback();
+    }
+
+    void CompletionReactor::run()
+    {
+        std::vector<SemaphoreWait> semaphores{};
+
+        while(true)
+        {
+            uint64_t observedWake = 0;
+            std::vector<Callback> ready{};
+            std::list<std::jthread> finishedThreads{};
+            {
+                std::lock_guard lock{mutex};
+                std::ranges::move(pendingSemaphores, std::back_inserter(semaphores));
+                pendingSemaphores.clear();
+                for(FenceWait& wait : completedFences)
+                {
+                    ready.push_back(std::move(wait.callback));
+                }
+                completedFences.clear();
+                for(auto it : finishedFenceThreads)
+                {
+                    finishedThreads.splice(finishedThreads.end(), fenceThreads, it);
+                }
+                finishedFenceThreads.clear();
+
+                if(stopping && ready.empty() && fenceThreads.empty() && semaphores.empty())
+                    return;
+                observedWake = wakeValue;
+            }
+
+            bool deviceLost = false;
+            if(ready.empty())
+            {
+                try
+                {
+                    std::vector<vk::Semaphore> waitSemaphores{ wakeSemaphore };
+                    std::vector<uint64_t> waitValues{ observedWake + 1 };
+                    for(const SemaphoreWait& wait : semaphores)
+                    {
+                        waitSemaphores.push_back(wait.semaphore);
+                        waitValues.push_back(wait.value);
+                    }
+
+                    vk::SemaphoreWaitInfo waitInfo{ vk::SemaphoreWaitFlagBits::eAny, waitSemaphores, waitValues };
+                    static_cast<void>(p_device->waitSemaphores(waitInfo, UINT64_MAX));
+                }
+                catch(const vk::SystemError&)
+                {
+                    deviceLost = true;
+                }
+            }
+
+            std::erase_if(semaphores, [&](SemaphoreWait& wait)
+            {
+                if(!deviceLost && !isComplete({}, wait.semaphore, wait.value))
+                    return false;
+                ready.push_back(std::move(wait.callback));
+                return true;
+            });
+
+            if(ready.empty())
+                continue;
+
+            {
+                std::lock_guard lock{mutex};
+                outstanding -= ready.size();
+            }
+
+            for(Callback& callback : ready)
+            {
+                dispatch(std::move(callback));
+            }
+        }
+    }
+
+    void CompletionReactor::waitFence(std::list<std::jthread>::iterator self, FenceWait wait)
+    {
+        try
+        {
+            static_cast<void>(p_device->waitForFences(wait.fence, vk::True, UINT64_MAX));
+        }
+        catch(const vk::SystemError&)
+        {
+        }
+
+        {
+            std::lock_guard lock{mutex};
+            completedFences.push_back(std::move(wait));
+            finishedFenceThreads.push_back(self);
+        }
+        wake();
+    }
+
+    SyncPool::SyncPool(const vk::raii::Device& device, uint32_t fenceCount, uint32_t semaphoreCount)
+        : p_device{&device}
+    {
+        fences.reserve(fenceCount);
+        for(uint32_t i = 0; i < fenceCount; ++i)
+        {
+            fences.emplace_back(device, vk::FenceCreateInfo{});
+        }
+
+        semaphores.reserve(semaphoreCount);
+        for(uint32_t i = 0; i < semaphoreCount; ++i)
+        {
+            semaphores.emplace_back(device, vk::SemaphoreCreateInfo{});
+        }
+
+        this->fenceCount = fenceCount;
+        this->semaphoreCount = semaphoreCount;
+    }
+
+    vk::raii::Fence SyncPool::acquireFence()
+    {
+        std::lock_guard lock{mutex};
+        if(fences.empty())
+            resetFencesUnlocked();
+
+        if(fences.empty())
+        {
+            ++fenceCount;
+            return vk::raii::Fence{ *p_device, vk::FenceCreateInfo{} };
+        }
+
+        vk::raii::Fence fence = std::move(fences.back());
+        fences.pop_back();
+        return fence;
+    }
+
+    void SyncPool::releaseFence(vk::raii::Fence&& fence)
+    {
+        std::lock_guard lock{mutex};
+        retiredFences.push_back(std::move(fence));
+    }
+
+    void SyncPool::resetFences()
+    {
+        std::lock_guard lock{mutex};
+        resetFencesUnlocked();
+    }
+
+    void SyncPool::resetFencesUnlocked()
+    {
+        const auto& dispatcher = *p_device->getDispatcher();
+        VkDevice device = static_cast<VkDevice>(**p_device);
+
+        std::vector<vk::Fence> resetFences{};
+        std::erase_if(retiredFences, [&](vk::raii::Fence& fence)
+        {
+            if(static_cast<vk::Result>(dispatcher.vkGetFenceStatus(device, static_cast<VkFence>(*fence))) != vk::Result::eSuccess)
+                return false;
+
+            resetFences.push_back(*fence);
+            fences.push_back(std::move(fence));
+            return true;
+        });
+
+        if(!resetFences.empty())
+            p_device->resetFences(resetFences);
+    }
+
+    vk::raii::Semaphore SyncPool::acquireSemaphore()
+    {
+        std::lock_guard lock{mutex};
+        if(semaphores.empty())
+            collectSemaphoresUnlocked();
+
+        if(semaphores.empty())
+        {
+            ++semaphoreCount;
+            return vk::raii::Semaphore{ *p_device, vk::SemaphoreCreateInfo{} };
+        }
+
+        vk::raii::Semaphore semaphore = std::move(semaphores.back());
+        semaphores.pop_back();
+        return semaphore;
+    }
+
+    void SyncPool::releaseSemaphore(vk::raii::Semaphore&& semaphore, vk::Fence waitFence)
+    {
+        std::lock_guard lock{mutex};
+        pendingSemaphores.emplace_back(std::move(semaphore), waitFence, vk::Semaphore{}, 0);
+    }
+
+    void SyncPool::releaseSemaphore(vk::raii::Semaphore&& semaphore, vk::Semaphore timeline, uint64_t value)
+    {
+        std::lock_guard lock{mutex};
+        pendingSemaphores.emplace_back(std::move(semaphore), vk::Fence{}, timeline, value);
+    }
+
+    void SyncPool::collectSemaphores()
+    {
+        std::lock_guard lock{mutex};
+        collectSemaphoresUnlocked();
+    }
+
+    void SyncPool::collectSemaphoresUnlocked()
+    {
+        const auto& dispatcher = *p_device->getDispatcher();
+        VkDevice device = static_cast<VkDevice>(**p_device);
+
+        std::erase_if(pendingSemaphores, [&](PendingSemaphore& pending)
+        {
+            bool complete = true;
+            if(pending.fence)
+            {
+                complete = static_cast<vk::Result>(dispatcher.vkGetFenceStatus(device, static_cast<VkFence>(pending.fence))) == vk::Result::eSuccess;
+            }
+            else if(pending.timeline)
+            {
+                uint64_t counter = 0;
+                dispatcher.vkGetSemaphoreCounterValue(device, static_cast<VkSemaphore>(pending.timeline), &counter);
+                complete = counter >= pending.value;
+            }
+
+            if(complete)
+                semaphores.push_back(std::move(pending.semaphore));
+            return complete;
+        });
+    }
+
+    CompletionReactor* getDefaultCompletionReactor() noexcept
+    {
+        return default_completion_reactor;
+    }
+
+    CompletionReactor* setDefaultCompletionReactor(CompletionReactor* reactor) noexcept
+    {
+        default_completion_reactor = reactor;
+        return default_completion_reactor;
+    }
+}
\ No newline at end of file
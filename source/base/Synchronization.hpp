@@ -4,17 +4,248 @@
 
 #include <concepts>
 #include <coroutine>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
 
 namespace vke{
 
+    class Device;
+    class DeviceQueue;
+
+    class TimelineSemaphore
+    {
+    public:
+        explicit TimelineSemaphore(const vk::raii::Device& device, uint64_t initialValue = 0);
+
+        inline operator const vk::raii::Semaphore&() const & noexcept { return semaphore; }
+        inline operator vk::Semaphore() const & noexcept { return *semaphore; }
+        inline const auto* operator->() const & noexcept { return &semaphore; }
+
+        void signal(uint64_t value) const;
+        bool wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+        uint64_t getValue() const;
+
+    private:
+        const vk::raii::Device* p_device = nullptr;
+        vk::raii::Semaphore semaphore{nullptr};
+    };
+
+    class DeletionQueue
+    {
+    public:
+        explicit DeletionQueue(const Device& device);
+        ~DeletionQueue();
+
+        DeletionQueue(const DeletionQueue&) = delete;
+        DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+        // Parks the deleter until every queue of the device has completed what was submitted to it so far.
+        void enqueue(std::move_only_function<void()> deleter);
+
+        template<class T>
+            requires (!std::is_lvalue_reference_v<T>)
+        inline void retire(T&& object) { enqueue([object = std::move(object)]{}); }
+
+        void collect();
+        void flush();
+
+        size_t size() const;
+
+    private:
+        struct Epoch
+        {
+            std::vector<uint64_t> values;
+            std::vector<std::move_only_function<void()>> deleters;
+        };
+
+        std::vector<const DeviceQueue*> queues;
+        mutable std::mutex mutex;
+        std::vector<uint64_t> completedValues;
+        std::deque<Epoch> epochs;
+        size_t entryCount = 0;
+
+        bool isCompleteUnlocked(std::span<const uint64_t> values) const noexcept;
+    };
+
+    DeletionQueue* getDefaultDeletionQueue() noexcept;
+    DeletionQueue* setDefaultDeletionQueue(DeletionQueue* queue) noexcept;
+
+    template<class T>
+    class DeferredHandle
+    {
+    public:
+        DeferredHandle(std::nullptr_t) noexcept {}
+        DeferredHandle(T&& handle, DeletionQueue* queue = getDefaultDeletionQueue()) noexcept
+            : handle_{std::move(handle)}, p_queue{queue} {}
+        ~DeferredHandle() { release(); }
+
+        DeferredHandle(DeferredHandle&& other) noexcept 
+            : handle_{std::exchange(other.handle_, T{nullptr})}, p_queue{other.p_queue} {}
+        DeferredHandle& operator=(DeferredHandle&& other) noexcept
+        {
+            if(this != &other)
+            {
+                release();
+                handle_ = std::exchange(other.handle_, T{nullptr});
+                p_queue = other.p_queue;
+            }
+            return *this;
+        }
+
+        DeferredHandle& operator=(T&& handle)
+        {
+            release();
+            handle_ = std::move(handle);
+            return *this;
+        }
+
+        inline operator const T& () const & noexcept { return handle_; }
+        inline const T& get() const & noexcept { return handle_; }
+        inline const T* operator->() const & noexcept { return &handle_; }
+        inline const auto& operator*() const & noexcept { return *handle_; }
+
+    private:
+        T handle_{nullptr};
+        DeletionQueue* p_queue = getDefaultDeletionQueue();
+
+        inline void release()
+        {
+            if(p_queue && static_cast<bool>(*handle_))
+                p_queue->retire(std::exchange(handle_, T{nullptr}));
+        }
+    };
+
+    class CompletionReactor
+    {
+    public:
+        using Callback = std::move_only_function<void()>;
+        using Executor = std::function<void(Callback)>;
+
+        struct CreateInfo
+        {
+            Executor executor{};
+        };
+
+        struct Awaitable
+        {
+            CompletionReactor* p_reactor = nullptr;
+            vk::Fence fence{};
+            vk::Semaphore semaphore{};
+            uint64_t value = 0;
+
+            inline bool await_ready() const { return p_reactor->isComplete(fence, semaphore, value); }
+            inline void await_suspend(std::coroutine_handle<> handle) const
+            {
+                if(fence)
+                    p_reactor->watch(fence, [handle]{ handle.resume(); });
+                else
+                    p_reactor->watch(semaphore, value, [handle]{ handle.resume(); });
+            }
+            inline void await_resume() const noexcept {}
+        };
+
+        CompletionReactor(const vk::raii::Device& device, const CreateInfo& createInfo);
+        ~CompletionReactor();
+
+        CompletionReactor(const CompletionReactor&) = delete;
+        CompletionReactor& operator=(const CompletionReactor&) = delete;
+
+        void watch(vk::Fence fence, Callback callback);
+        void watch(vk::Semaphore semaphore, uint64_t value, Callback callback);
+
+        inline Awaitable wait(vk::Fence fence) { return { this, fence, {}, 0 }; }
+        inline Awaitable wait(vk::Semaphore semaphore, uint64_t value) { return { this, {}, semaphore, value }; }
+
+        bool isComplete(vk::Fence fence, vk::Semaphore semaphore, uint64_t value) const;
+        size_t size() const;
+
+    private:
+        struct FenceWait
+        {
+            vk::Fence fence;
+            Callback callback;
+        };
+
+        struct SemaphoreWait
+        {
+            vk::Semaphore semaphore;
+            uint64_t value;
+            Callback callback;
+        };
+
+        const vk::raii::Device* p_device = nullptr;
+        Executor executor;
+        TimelineSemaphore wakeSemaphore;
+
+        mutable std::mutex mutex;
+        uint64_t wakeValue = 0;
+        size_t outstanding = 0;
+        bool stopping = false;
+        std::vector<FenceWait> completedFences;
+        std::vector<SemaphoreWait> pendingSemaphores;
+        // Fences can't join a timeline wait, so each one is waited on by its own thread that wakes the reactor.
+        std::list<std::jthread> fenceThreads;
+        std::vector<std::list<std::jthread>::iterator> finishedFenceThreads;
+
+        std::jthread thread;
+
+        void wake();
+        void run();
+        void waitFence(std::list<std::jthread>::iterator self, FenceWait wait);
+        void dispatch(Callback&& callback);
+    };
+
+    CompletionReactor* getDefaultCompletionReactor() noexcept;
+    CompletionReactor* setDefaultCompletionReactor(CompletionReactor* reactor) noexcept;
+
     class SyncPool
     {
     public:
         SyncPool(const vk::raii::Device& device, uint32_t fenceCount, uint32_t semaphoreCount);
 
+        SyncPool(const SyncPool&) = delete;
+        SyncPool& operator=(const SyncPool&) = delete;
+
+        vk::raii::Fence acquireFence();
+        // The fence is reused only after it has signalled, like semaphores released with a wait.
+        void releaseFence(vk::raii::Fence&& fence);
+        void resetFences();
+
+        vk::raii::Semaphore acquireSemaphore();
+        void releaseSemaphore(vk::raii::Semaphore&& semaphore, vk::Fence waitFence);
+        void releaseSemaphore(vk::raii::Semaphore&& semaphore, vk::Semaphore timeline, uint64_t value);
+        void collectSemaphores();
+
+        inline size_t getFenceCount() const noexcept { return fenceCount; }
+        inline size_t getSemaphoreCount() const noexcept { return semaphoreCount; }
+
     private:
+        struct PendingSemaphore
+        {
+            vk::raii::Semaphore semaphore;
+            vk::Fence fence;
+            vk::Semaphore timeline;
+            uint64_t value;
+        };
+
+        const vk::raii::Device* p_device = nullptr;
+        std::mutex mutex;
         std::vector<vk::raii::Fence> fences;
+        std::vector<vk::raii::Fence> retiredFences;
         std::vector<vk::raii::Semaphore> semaphores;
+        std::vector<PendingSemaphore> pendingSemaphores;
+        size_t fenceCount = 0;
+        size_t semaphoreCount = 0;
+
+        void resetFencesUnlocked();
+        void collectSemaphoresUnlocked();
     };
 
     template<class Fence>
@@ -24,8 +255,15 @@ namespace vke{
         struct awaitable
         {
             Fence fence;
+            CompletionReactor* p_reactor = getDefaultCompletionReactor();
             bool await_ready() { return fence.getStatus() == vk::Result::eSuccess; }
-            void await_suspend(std::coroutine_handle<> h) { }
+            bool await_suspend(std::coroutine_handle<> h) 
+            {
+                if(!p_reactor)
+                    return false;
+                p_reactor->watch(*fence, [h]{ h.resume(); });
+                return true;
+            }
             void await_resume() 
             {
                 fence.getDispatcher()->vkWaitForFences(fence.getDevice(), 1, reinterpret_cast<const VkFence*>(&(*fence)), vk::True, UINT64_MAX);
@@ -0,0 +1,156 @@
+#include "Task.hpp"
+
+#include <cstddef>
+#include <new>
+
+namespace vke{
+    namespace{
+        thread_local FrameArena* current_frame_arena = nullptr;
+    }
+
+    struct FrameArena::Block
+    {
+        FrameArena* p_arena = nullptr;
+        size_t capacity = 0;
+        size_t offset = 0;
+        size_t liveCount = 0;
+    };
+
+    struct alignas(alignof(std::max_align_t)) FrameArena::Header
+    {
+        Block* p_block = nullptr;
+    };
+
+    FrameArena::FrameArena(size_t blockSize)
+        : blockSize{blockSize} {}
+
+    FrameArena::~FrameArena()
+    {
+        for(Block* block : blocks)
+        {
+            ::operator delete(block);
+        }
+    }
+
+    FrameArena::Scope::Scope(FrameArena& arena) noexcept
+        : p_previous{std::exchange(current_frame_arena, &arena)} {}
+
+    FrameArena::Scope::~Scope()
+    {
+        current_frame_arena = p_previous;
+    }
+
+    void* FrameArena::allocate(size_t size)
+    {
+        if(current_frame_arena)
+            return current_frame_arena->allocateBlock(size);
+
+        Header* header = static_cast<Header*>(::operator new(sizeof(Header) + size));
+        header->p_block = nullptr;
+        return header + 1;
+    }
+
+    void FrameArena::deallocate(void* pointer) noexcept
+    {
+        Header* header = static_cast<Header*>(pointer) - 1;
+        if(header->p_block)
+            header->p_block->p_arena->release(header->p_block);
+        else
+            ::operator delete(header);
+    }
+
+    FrameArena* FrameArena::getCurrent() noexcept
+    {
+        return current_frame_arena;
+    }
+
+    size_t FrameArena::getBlockCount() const
+    {
+        std::lock_guard lock{mutex};
+        return blocks.size();
+    }
+
+    size_t FrameArena::getLiveCount() const
+    {
+        std::lock_guard lock{mutex};
+        return liveCount;
+    }
+
+    void* FrameArena::allocateBlock(size_t size)
+    {
+        constexpr size_t alignment = alignof(std::max_align_t);
+        constexpr size_t blockHeaderSize = (sizeof(Block) + alignment - 1) / alignment * alignment;
+        size_t allocationSize = (sizeof(Header) + size + alignment - 1) / alignment * alignment;
+
+        std::lock_guard lock{mutex};
+
+        if(!p_current || p_current->offset + allocationSize > p_current->capacity)
+        {
+            if(p_current && p_current->liveCount == 0)
+                freeBlocks.push_back(p_current);
+
+            auto it = std::ranges::find_if(freeBlocks, [&](const Block* block){ return block->capacity >= allocationSize; });
+            if(it != freeBlocks.end())
+            {
+                p_current = *it;
+                freeBlocks.erase(it);
+            }
+            else
+            {
+                size_t capacity = std::max(blockSize, allocationSize);
+                p_current = new (::operator new(blockHeaderSize + capacity)) Block{ this, capacity, 0, 0 };
+                blocks.push_back(p_current);
+            }
+            p_current->offset = 0;
+        }
+
+        std::byte* data = reinterpret_cast<std::byte*>(p_current) + blockHeaderSize + p_current->offset;
+        p_current->offset += allocationSize;
+        ++p_current->liveCount;
+        ++liveCount;
+
+        Header* header = new (data) Header{ p_current };
+        return header + 1;
+    }
+
+    void FrameArena::release(Block* block) noexcept
+    {
+        std::lock_guard lock{mutex};
+        --liveCount;
+        if(--block->liveCount == 0)
+        {
+            if(block == p_current)
+                block->offset = 0;
+            else
+                freeBlocks.push_back(block);
+        }
+    }
+
+    namespace{
+        CompletionReactor& getTaskReactor()
+        {
+            CompletionReactor* reactor = getDefaultCompletionReactor();
+            if(!reactor)
+                throw std::runtime_error{"vke::completion requires a default CompletionReactor"};
+            return *reactor;
+        }
+    }
+
+    CompletionReactor::Awaitable completion(const DeviceQueue& queue, uint64_t value)
+    {
+        if(!queue.hasTimeline())
+            throw std::runtime_error{"vke::completion requires a DeviceQueue with a timeline semaphore"};
+        return getTaskReactor().wait(queue.getSemaphore(), value);
+    }
+
+    CompletionReactor::Awaitable completion(SubmissionQueue& queue)
+    {
+        queue.flush();
+        return completion(queue.getQueue(), queue.getQueue().getSubmittedValue());
+    }
+
+    CompletionReactor::Awaitable completion(const QueueOrchestrator& orchestrator, QueueOrchestrator::Ticket ticket)
+    {
+        return getTaskReactor().wait(orchestrator.getSemaphore(ticket.lane), ticket.value);
+    }
+}
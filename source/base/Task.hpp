@@ -0,0 +1,320 @@
+#pragma once
+
+#include "Queue.hpp"
+#include "Submission.hpp"
+#include "Synchronization.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <variant>
+
+namespace vke{
+
+    class FrameArena
+    {
+    public:
+        explicit FrameArena(size_t blockSize = 64 * 1024);
+        ~FrameArena();
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        class Scope
+        {
+        public:
+            explicit Scope(FrameArena& arena) noexcept;
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            FrameArena* p_previous = nullptr;
+        };
+
+        static void* allocate(size_t size);
+        static void deallocate(void* pointer) noexcept;
+        static FrameArena* getCurrent() noexcept;
+
+        size_t getBlockCount() const;
+        size_t getLiveCount() const;
+
+    private:
+        struct Block;
+        struct Header;
+
+        size_t blockSize;
+        mutable std::mutex mutex;
+        std::vector<Block*> blocks;
+        std::vector<Block*> freeBlocks;
+        Block* p_current = nullptr;
+        size_t liveCount = 0;
+
+        void* allocateBlock(size_t size);
+        void release(Block* block) noexcept;
+    };
+
+    struct TaskCancelled : std::exception
+    {
+        inline const char* what() const noexcept override { return "vke::Task was cancelled"; }
+    };
+
+    struct GetStopToken {};
+    inline constexpr GetStopToken getStopToken{};
+
+    // Awaitables for submitted GPU work, resumed by the default CompletionReactor.
+    CompletionReactor::Awaitable completion(const DeviceQueue& queue, uint64_t value);
+    CompletionReactor::Awaitable completion(SubmissionQueue& queue);
+    CompletionReactor::Awaitable completion(const QueueOrchestrator& orchestrator, QueueOrchestrator::Ticket ticket);
+
+    template<class Memory>
+    struct ReadbackAwaitable
+    {
+        CompletionReactor::Awaitable awaitable;
+        const Memory& memory;
+
+        inline bool await_ready() const { return awaitable.await_ready(); }
+        inline void await_suspend(std::coroutine_handle<> handle) const { awaitable.await_suspend(handle); }
+        inline void await_resume() const { memory.invalidate(); }
+    };
+
+    // Resumes once the copy has completed, with the mapped memory invalidated for the host.
+    template<class Memory>
+        requires requires(const Memory& memory) { memory.invalidate(); }
+    inline ReadbackAwaitable<Memory> readback(CompletionReactor::Awaitable awaitable, const Memory& memory)
+    {
+        return { awaitable, memory };
+    }
+
+    class TaskPromiseBase
+    {
+    public:
+        struct FinalAwaiter
+        {
+            inline bool await_ready() const noexcept { return false; }
+
+            template<class Promise>
+            inline std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+            {
+                std::coroutine_handle<> continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            inline void await_resume() const noexcept {}
+        };
+
+        template<class Awaiter>
+        struct CancellableAwaiter
+        {
+            Awaiter awaiter;
+            const std::stop_token& stopToken;
+
+            inline bool await_ready() 
+            { 
+                if(stopToken.stop_requested())
+                    throw TaskCancelled{};
+                return awaiter.await_ready(); 
+            }
+
+            template<class Promise>
+            inline decltype(auto) await_suspend(std::coroutine_handle<Promise> handle) { return awaiter.await_suspend(handle); }
+
+            inline decltype(auto) await_resume() 
+            {
+                if(stopToken.stop_requested())
+                    throw TaskCancelled{};
+                return awaiter.await_resume(); 
+            }
+        };
+
+        struct StopForwarder
+        {
+            std::stop_source* p_stopSource = nullptr;
+
+            inline void operator()() const noexcept { p_stopSource->request_stop(); }
+        };
+
+        struct StopTokenAwaiter
+        {
+            std::stop_token stopToken;
+
+            inline bool await_ready() const noexcept { return true; }
+            inline void await_suspend(std::coroutine_handle<>) const noexcept {}
+            inline std::stop_token await_resume() const noexcept { return stopToken; }
+        };
+
+        inline static void* operator new(size_t size) { return FrameArena::allocate(size); }
+        inline static void operator delete(void* pointer) noexcept { FrameArena::deallocate(pointer); }
+
+        inline std::suspend_always initial_suspend() const noexcept { return {}; }
+        inline FinalAwaiter final_suspend() const noexcept { return {}; }
+        inline void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+        template<class Awaitable>
+        inline auto await_transform(Awaitable&& awaitable)
+        {
+            using Awaiter = decltype(getAwaiter(std::forward<Awaitable>(awaitable)));
+            return CancellableAwaiter<Awaiter>{ getAwaiter(std::forward<Awaitable>(awaitable)), stopToken };
+        }
+
+        inline StopTokenAwaiter await_transform(GetStopToken) const noexcept { return { stopToken }; }
+
+        std::coroutine_handle<> continuation{};
+        std::exception_ptr exception{};
+        std::stop_source stopSource{};
+        std::stop_token stopToken{ stopSource.get_token() };
+        std::optional<std::stop_callback<StopForwarder>> parentStopCallback{};
+
+    private:
+        template<class Awaitable>
+        inline static decltype(auto) getAwaiter(Awaitable&& awaitable)
+        {
+            if constexpr (requires { std::forward<Awaitable>(awaitable).operator co_await(); })
+                return std::forward<Awaitable>(awaitable).operator co_await();
+            else if constexpr (requires { operator co_await(std::forward<Awaitable>(awaitable)); })
+                return operator co_await(std::forward<Awaitable>(awaitable));
+            else
+                return std::forward<Awaitable>(awaitable);
+        }
+    };
+
+    template<class Promise>
+    struct TaskAwaiter
+    {
+        std::coroutine_handle<Promise> handle;
+
+        inline bool await_ready() const noexcept { return !handle || handle.done(); }
+
+        template<class Continuation>
+        inline std::coroutine_handle<> await_suspend(std::coroutine_handle<Continuation> continuation) const noexcept
+        {
+            handle.promise().continuation = continuation;
+            if constexpr (std::derived_from<Continuation, TaskPromiseBase>)
+                handle.promise().parentStopCallback.emplace(continuation.promise().stopToken, 
+                    TaskPromiseBase::StopForwarder{ &handle.promise().stopSource });
+            return handle;
+        }
+
+        inline decltype(auto) await_resume() const { return handle.promise().getResult(); }
+    };
+
+    template<class T = void>
+    class Task
+    {
+    public:
+        struct promise_type : TaskPromiseBase
+        {
+            inline Task get_return_object() noexcept { return Task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+
+            template<class U>
+                requires std::convertible_to<U, T>
+            inline void return_value(U&& value) { result.emplace(std::forward<U>(value)); }
+
+            inline T getResult()
+            {
+                if(exception)
+                    std::rethrow_exception(exception);
+                if(!result)
+                    throw std::runtime_error{"vke::Task::get, Task has not completed"};
+                return std::move(*result);
+            }
+
+            std::optional<T> result{};
+        };
+
+        Task() noexcept = default;
+        Task(Task&& other) noexcept : handle{ std::exchange(other.handle, nullptr) } {}
+        Task& operator=(Task&& other) noexcept
+        {
+            if(this != &other)
+            {
+                if(handle)
+                    handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+        ~Task()
+        {
+            if(handle)
+                handle.destroy();
+        }
+
+        inline bool done() const noexcept { return !handle || handle.done(); }
+        inline void start() const { if(!done()) handle.resume(); }
+        inline void cancel() const noexcept { if(handle) handle.promise().stopSource.request_stop(); }
+
+        inline T get() && 
+        { 
+            if(!handle)
+                throw std::runtime_error{"vke::Task::get, Task has not completed"};
+            return handle.promise().getResult(); 
+        }
+
+        inline TaskAwaiter<promise_type> operator co_await() && noexcept { return { handle }; }
+
+    private:
+        std::coroutine_handle<promise_type> handle{};
+
+        explicit Task(std::coroutine_handle<promise_type> handle_) noexcept : handle{ handle_ } {}
+    };
+
+    template<>
+    class Task<void>
+    {
+    public:
+        struct promise_type : TaskPromiseBase
+        {
+            inline Task get_return_object() noexcept { return Task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+            inline void return_void() const noexcept {}
+
+            inline void getResult() const
+            {
+                if(exception)
+                    std::rethrow_exception(exception);
+            }
+        };
+
+        Task() noexcept = default;
+        Task(Task&& other) noexcept : handle{ std::exchange(other.handle, nullptr) } {}
+        Task& operator=(Task&& other) noexcept
+        {
+            if(this != &other)
+            {
+                if(handle)
+                    handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+        ~Task()
+        {
+            if(handle)
+                handle.destroy();
+        }
+
+        inline bool done() const noexcept { return !handle || handle.done(); }
+        inline void start() const { if(!done()) handle.resume(); }
+        inline void cancel() const noexcept { if(handle) handle.promise().stopSource.request_stop(); }
+
+        inline void get() && 
+        { 
+            if(!done())
+                throw std::runtime_error{"vke::Task::get, Task has not completed"};
+            if(handle)
+                handle.promise().getResult(); 
+        }
+
+        inline TaskAwaiter<promise_type> operator co_await() && noexcept { return { handle }; }
+
+    private:
+        std::coroutine_handle<promise_type> handle{};
+
+        explicit Task(std::coroutine_handle<promise_type> handle_) noexcept : handle{ handle_ } {}
+    };
+
+}
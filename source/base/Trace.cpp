@@ -0,0 +1,54 @@
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <ranges>
+
+namespace vke{
+    int64_t getTraceTime() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::string escapeJson(std::string_view text)
+    {
+        std::string escaped{};
+        escaped.reserve(text.size());
+        for(char c : text)
+        {
+            switch(c)
+            {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20)
+                    escaped += std::format("\\u{:04x}", static_cast<unsigned>(c));
+                else
+                    escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    void writeChromeTrace(std::ostream& stream, std::span<const TraceEvent> events)
+    {
+        int64_t origin = events.empty() ? 0 : std::ranges::min(events | std::ranges::views::transform(&TraceEvent::begin));
+
+        stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        for(const auto& [index, event] : events | std::views::enumerate)
+        {
+            stream << (index ? ",\n" : "\n");
+            if(event.type == TraceEvent::Type::eCounter)
+                stream << std::format("{{\"name\":\"{}\",\"ph\":\"C\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"args\":{{\"value\":{}}}}}",
+                    escapeJson(event.name), event.processId, event.threadId, static_cast<double>(event.begin - origin) / 1000.0, event.value);
+            else
+                stream << std::format("{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                    escapeJson(event.name), event.processId, event.threadId, 
+                    static_cast<double>(event.begin - origin) / 1000.0, static_cast<double>(event.end - event.begin) / 1000.0);
+        }
+        stream << "\n]}\n";
+    }
+}
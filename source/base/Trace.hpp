@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace vke{
+
+    struct TraceEvent
+    {
+        enum class Type : uint8_t
+        {
+            eZone,
+            eCounter
+        };
+
+        std::string name;
+        uint32_t processId = 0;
+        uint32_t threadId = 0;
+        int64_t begin = 0;
+        int64_t end = 0;
+        Type type = Type::eZone;
+        int64_t value = 0;
+    };
+
+    int64_t getTraceTime() noexcept;
+    std::string escapeJson(std::string_view text);
+    void writeChromeTrace(std::ostream& stream, std::span<const TraceEvent> events);
+
+}
@@ -2,4 +2,37 @@
 
 namespace vke{
 
+    std::vector<const char*> HeadlessInstance::getInstanceExtensions() const
+    {
+        return { VK_KHR_SURFACE_EXTENSION_NAME, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME };
+    }
+
+    HeadlessWindow::HeadlessWindow(const Instance& instance, const CreateInfo& createInfo)
+        : extent{createInfo.width, createInfo.height}
+    {
+        triggerSetFramebufferSize = createInfo.triggerSetFramebufferSize;
+
+        if(instance.isExtensionEnabled(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME))
+        {
+            surface = vk::raii::SurfaceKHR{instance, vk::HeadlessSurfaceCreateInfoEXT{}};
+        }
+    }
+
+    vk::Extent2D HeadlessWindow::getExtent2D() const
+    {
+        return extent;
+    }
+
+    bool HeadlessWindow::shouldClose() const
+    {
+        return closed;
+    }
+
+    void HeadlessWindow::setExtent2D(vk::Extent2D extent_)
+    {
+        extent = extent_;
+
+        if(triggerSetFramebufferSize)
+            triggerSetFramebufferSize(extent.width, extent.height);
+    }
 }
\ No newline at end of file
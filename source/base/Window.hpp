@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Common.hpp"
+#include "Base.hpp"
 
 namespace vke{
     class WindowApplicationInstance
@@ -41,4 +41,35 @@ namespace vke{
         std::function<void(uint32_t width, uint32_t height)> triggerSetFramebufferSize;
     };
 
+    class HeadlessInstance final : public WindowApplicationInstance
+    {
+    public:
+        std::vector<const char*> getInstanceExtensions() const override;
+    };
+
+    class HeadlessWindow final : public Window
+    {
+    public:
+        struct CreateInfo
+        {
+            uint32_t width;
+            uint32_t height;
+            std::function<void(uint32_t width, uint32_t height)> triggerSetFramebufferSize;
+        };
+
+        HeadlessWindow(const Instance& instance, const CreateInfo& createInfo);
+
+        vk::Extent2D getExtent2D() const override;
+        bool shouldClose() const override;
+
+        void setExtent2D(vk::Extent2D extent);
+        inline void close() noexcept { closed = true; }
+
+        inline bool hasSurface() const noexcept { return static_cast<bool>(*surface); }
+
+    private:
+        vk::Extent2D extent{};
+        bool closed = false;
+    };
+
 }
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "DeviceGroup.hpp"
+
+#include <cstring>
+
+namespace vke{
+
+    DeviceGroup::DeviceGroup(const vk::raii::Instance& instance, const CreateInfo& createInfo)
+    {
+        auto physicalDevices = std::ranges::to<std::vector<vk::raii::PhysicalDevice>>(instance.enumeratePhysicalDevices()
+            | std::ranges::views::filter(createInfo.physicalDeviceChecker)
+            | std::ranges::views::take(createInfo.maxDeviceCount));
+
+        if(physicalDevices.empty())
+            throw std::runtime_error("vke::DeviceGroup found no suitable physical device");
+
+        for(const vk::raii::PhysicalDevice& physicalDevice : physicalDevices)
+        {
+            vk::PhysicalDevice target = *physicalDevice;
+
+            Device::CreateInfo deviceCreateInfo = createInfo.deviceCreateInfo;
+            deviceCreateInfo.physicalDevicSelecter = Selecter<PhysicalDeviceCapabilities>{ 
+                [](const vk::raii::PhysicalDevice&) -> uint32_t { return 1; },
+                [target](const vk::raii::PhysicalDevice& p) -> bool { return *p == target; } };
+
+            Device device{instance, deviceCreateInfo};
+
+            auto queueFamilyProperties = device.getPhysicalDevice().getQueueFamilyProperties();
+            const DeviceQueue* queue = nullptr;
+            for(const auto& [queueFamilyIndex, properties] : queueFamilyProperties | std::views::enumerate)
+            {
+                auto queues = device.getDeviceQueues(static_cast<uint32_t>(queueFamilyIndex));
+                if(!queues.empty() && (properties.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute | vk::QueueFlagBits::eTransfer)))
+                {
+                    queue = &queues.front();
+                    break;
+                }
+            }
+
+            if(!queue)
+                throw std::runtime_error("vke::DeviceGroup requires a queue on every device");
+
+            members.push_back(std::make_unique<Member>(std::move(device), *queue, std::max(createInfo.threadsPerDevice(), 1u)));
+        }
+    }
+
+    DeviceGroup::Member::Member(Device&& device_, const DeviceQueue& queue, uint32_t threadCount)
+        : device{std::move(device_)}, p_queue{&queue}, memoryResource{device}, mappedMemory{device.getPhysicalDevice(), &memoryResource},
+        commandPool{device, vk::CommandPoolCreateInfo{ vk::CommandPoolCreateFlagBits::eTransient, queue.getQueueFamilyIndex() }}, 
+        pool{threadCount} {}
+
+    void DeviceGroup::copyBuffer(uint32_t srcDeviceIndex, vk::Buffer srcBuffer, vk::DeviceSize srcOffset, 
+        uint32_t dstDeviceIndex, vk::Buffer dstBuffer, vk::DeviceSize dstOffset, vk::DeviceSize size)
+    {
+        Member& src = *members[srcDeviceIndex];
+        Member& dst = *members[dstDeviceIndex];
+
+        if(srcDeviceIndex == dstDeviceIndex)
+        {
+            submitAndWait(src, [&](const vk::raii::CommandBuffer& commandBuffer)
+            {
+                commandBuffer.copyBuffer(srcBuffer, dstBuffer, vk::BufferCopy{ srcOffset, dstOffset, size });
+            });
+            return;
+        }
+
+        Buffer<std::byte> readback{src.device, BufferWrapper::CreateInfo{ 
+            .size = size, .usage = vk::BufferUsageFlags{vk::BufferUsageFlagBits::eTransferDst} }, DeviceMemoryAllocator<std::byte>{src.mappedMemory}};
+        Buffer<std::byte> upload{dst.device, BufferWrapper::CreateInfo{ 
+            .size = size, .usage = vk::BufferUsageFlags{vk::BufferUsageFlagBits::eTransferSrc} }, DeviceMemoryAllocator<std::byte>{dst.mappedMemory}};
+
+        submitAndWait(src, [&](const vk::raii::CommandBuffer& commandBuffer)
+        {
+            commandBuffer.copyBuffer(srcBuffer, static_cast<vk::Buffer>(readback), vk::BufferCopy{ srcOffset, 0, size });
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, 
+                vk::MemoryBarrier{ vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead }, {}, {});
+        });
+
+        readback.invalidate();
+        std::memcpy(upload.data(), readback.data(), size);
+        upload.flush();
+
+        submitAndWait(dst, [&](const vk::raii::CommandBuffer& commandBuffer)
+        {
+            commandBuffer.copyBuffer(static_cast<vk::Buffer>(upload), dstBuffer, vk::BufferCopy{ 0, dstOffset, size });
+        });
+    }
+
+    uint32_t DeviceGroup::acquireDevice() noexcept
+    {
+        uint32_t start = roundRobinCounter.fetch_add(1, std::memory_order_relaxed);
+        uint32_t bestIndex = start % members.size();
+        uint32_t bestLoad = UINT32_MAX;
+
+        for(uint32_t i = 0; i < members.size(); ++i)
+        {
+            uint32_t index = (start + i) % members.size();
+            uint32_t load = members[index]->load.load(std::memory_order_relaxed);
+            if(load < bestLoad)
+            {
+                bestIndex = index;
+                bestLoad = load;
+            }
+        }
+
+        members[bestIndex]->load.fetch_add(1, std::memory_order_relaxed);
+        return bestIndex;
+    }
+
+    void DeviceGroup::submitAndWait(Member& member, const std::function<void(const vk::raii::CommandBuffer&)>& recordFunction)
+    {
+        const vk::raii::Device& device = member.device;
+        vk::raii::Fence fence{ device, vk::FenceCreateInfo{} };
+        vk::raii::CommandBuffer commandBuffer{ nullptr };
+
+        {
+            std::lock_guard lock{member.mutex};
+            commandBuffer = std::move(vk::raii::CommandBuffers{ device, 
+                vk::CommandBufferAllocateInfo{ *member.commandPool, vk::CommandBufferLevel::ePrimary, 1 } }.front());
+
+            commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+            recordFunction(commandBuffer);
+            commandBuffer.end();
+
+            vk::CommandBuffer submitCommandBuffer = *commandBuffer;
+            member.p_queue->submit(vk::SubmitInfo{}.setCommandBuffers(submitCommandBuffer), *fence);
+        }
+
+        vk::Result result = device.waitForFences(*fence, vk::True, UINT64_MAX);
+        vk::detail::resultCheck( result, "vke::DeviceGroup::submitAndWait" );
+
+        std::lock_guard lock{member.mutex};
+        commandBuffer.clear();
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <base/Base.hpp>
+#include <base/Memory.hpp>
+#include <base/Resources.hpp>
+
+#include <stdexec/execution.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace vke{
+
+    class DeviceGroup
+    {
+    public:
+        struct CreateInfo
+        {
+            Checker<vk::raii::PhysicalDevice> physicalDeviceChecker{true};
+            uint32_t maxDeviceCount = UINT32_MAX;
+            Device::CreateInfo deviceCreateInfo;
+            Getter<uint32_t> threadsPerDevice{ 1u };
+        };
+
+        DeviceGroup(const vk::raii::Instance& instance, const CreateInfo& createInfo);
+
+        DeviceGroup(const DeviceGroup&) = delete;
+        DeviceGroup& operator=(const DeviceGroup&) = delete;
+
+        template<class F>
+            requires std::invocable<F&, Device&, uint32_t>
+        auto execute(F&& job)
+        {
+            return stdexec::let_value(stdexec::just(), [this, job = std::forward<F>(job)]() mutable
+            {
+                uint32_t deviceIndex = acquireDevice();
+                return stdexec::schedule(members[deviceIndex]->pool.get_scheduler())
+                    | stdexec::then([this, deviceIndex, &job]() -> std::invoke_result_t<F&, Device&, uint32_t>
+                    {
+                        LoadGuard guard{members[deviceIndex]->load};
+                        return std::invoke(job, members[deviceIndex]->device, deviceIndex);
+                    });
+            });
+        }
+
+        void copyBuffer(uint32_t srcDeviceIndex, vk::Buffer srcBuffer, vk::DeviceSize srcOffset, 
+            uint32_t dstDeviceIndex, vk::Buffer dstBuffer, vk::DeviceSize dstOffset, vk::DeviceSize size);
+
+        inline size_t size() const noexcept { return members.size(); }
+        inline Device& getDevice(uint32_t deviceIndex) noexcept { return members[deviceIndex]->device; }
+        inline const DeviceQueue& getQueue(uint32_t deviceIndex) const noexcept { return *members[deviceIndex]->p_queue; }
+        inline auto getScheduler(uint32_t deviceIndex) noexcept { return members[deviceIndex]->pool.get_scheduler(); }
+        inline uint32_t getLoad(uint32_t deviceIndex) const noexcept { return members[deviceIndex]->load.load(std::memory_order_relaxed); }
+
+    private:
+        struct Member
+        {
+            Member(Device&& device_, const DeviceQueue& queue, uint32_t threadCount);
+
+            Device device;
+            const DeviceQueue* p_queue = nullptr;
+            NewDeleteDeviceMemoryResource memoryResource;
+            MappedDeviceMemoryResource mappedMemory;
+            vk::raii::CommandPool commandPool;
+            std::mutex mutex;
+            std::atomic<uint32_t> load{0};
+            exec::static_thread_pool pool;
+        };
+
+        struct LoadGuard
+        {
+            std::atomic<uint32_t>& load;
+            ~LoadGuard() { load.fetch_sub(1, std::memory_order_relaxed); }
+        };
+
+        std::vector<std::unique_ptr<Member>> members;
+        std::atomic<uint32_t> roundRobinCounter{0};
+
+        uint32_t acquireDevice() noexcept;
+        void submitAndWait(Member& member, const std::function<void(const vk::raii::CommandBuffer&)>& recordFunction);
+    };
+
+}
@@ -0,0 +1,69 @@
+#include "ParallelRecorder.hpp"
+
+#include <latch>
+
+namespace vke{
+
+    ParallelRecorder::ParallelRecorder(CommandPoolManager& commandPoolManager, const CreateInfo& createInfo)
+        : p_commandPoolManager{&commandPoolManager}, threadCount{std::max(createInfo.threadCount(), 1u)}, 
+        chunksPerThread{std::max(createInfo.chunksPerThread, 1u)}, pool{threadCount} {}
+
+    std::vector<vk::CommandBuffer> ParallelRecorder::recordSecondary(const RecordInfo& recordInfo, const RecordFunction& recordFunction)
+    {
+        uint32_t chunkCount = std::min(recordInfo.itemCount, recordInfo.chunkCount ? recordInfo.chunkCount : threadCount * chunksPerThread);
+        if(chunkCount == 0)
+            return {};
+
+        const auto* renderingInfo = static_cast<const vk::BaseInStructure*>(recordInfo.inheritanceInfo.pNext);
+        bool renderPassContinue = recordInfo.inheritanceInfo.renderPass || 
+            (renderingInfo && renderingInfo->sType == vk::StructureType::eCommandBufferInheritanceRenderingInfo);
+
+        vk::CommandBufferBeginInfo beginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit, &recordInfo.inheritanceInfo };
+        if(renderPassContinue)
+            beginInfo.flags |= vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+
+        std::vector<vk::CommandBuffer> commandBuffers(chunkCount);
+        std::latch latch{chunkCount};
+        std::mutex exceptionMutex;
+        std::exception_ptr exception{};
+
+        for(uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            uint32_t firstItem = static_cast<uint32_t>(static_cast<uint64_t>(recordInfo.itemCount) * chunk / chunkCount);
+            uint32_t lastItem = static_cast<uint32_t>(static_cast<uint64_t>(recordInfo.itemCount) * (chunk + 1) / chunkCount);
+
+            stdexec::start_detached(stdexec::schedule(pool.get_scheduler())
+                | stdexec::then([&, chunk, firstItem, lastItem]
+                {
+                    try
+                    {
+                        const vk::raii::CommandBuffer& commandBuffer = p_commandPoolManager->allocate(recordInfo.queueFamilyIndex, vk::CommandBufferLevel::eSecondary);
+                        commandBuffer.begin(beginInfo);
+                        recordFunction(commandBuffer, firstItem, lastItem - firstItem);
+                        commandBuffer.end();
+                        commandBuffers[chunk] = *commandBuffer;
+                    }
+                    catch(...)
+                    {
+                        std::lock_guard lock{exceptionMutex};
+                        if(!exception)
+                            exception = std::current_exception();
+                    }
+                    latch.count_down();
+                }));
+        }
+
+        latch.wait();
+        if(exception)
+            std::rethrow_exception(exception);
+
+        return commandBuffers;
+    }
+
+    void ParallelRecorder::record(const vk::raii::CommandBuffer& primaryCommandBuffer, const RecordInfo& recordInfo, const RecordFunction& recordFunction)
+    {
+        std::vector<vk::CommandBuffer> commandBuffers = recordSecondary(recordInfo, recordFunction);
+        if(!commandBuffers.empty())
+            primaryCommandBuffer.executeCommands(commandBuffers);
+    }
+}
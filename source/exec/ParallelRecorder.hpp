@@ -0,0 +1,47 @@
+#pragma once
+
+#include <base/Command.hpp>
+
+#include <stdexec/execution.hpp>
+#include <exec/static_thread_pool.hpp>
+
+namespace vke{
+
+    class ParallelRecorder
+    {
+    public:
+        struct CreateInfo
+        {
+            Getter<uint32_t> threadCount{ std::max(std::thread::hardware_concurrency(), 1u) };
+            uint32_t chunksPerThread = 4;
+        };
+
+        struct RecordInfo
+        {
+            uint32_t queueFamilyIndex = 0;
+            uint32_t itemCount = 0;
+            uint32_t chunkCount = 0;
+            vk::CommandBufferInheritanceInfo inheritanceInfo{};
+        };
+
+        using RecordFunction = std::function<void(const vk::raii::CommandBuffer& commandBuffer, uint32_t firstItem, uint32_t itemCount)>;
+
+        ParallelRecorder(CommandPoolManager& commandPoolManager, const CreateInfo& createInfo);
+
+        ParallelRecorder(const ParallelRecorder&) = delete;
+        ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+
+        std::vector<vk::CommandBuffer> recordSecondary(const RecordInfo& recordInfo, const RecordFunction& recordFunction);
+        void record(const vk::raii::CommandBuffer& primaryCommandBuffer, const RecordInfo& recordInfo, const RecordFunction& recordFunction);
+
+        inline uint32_t getThreadCount() const noexcept { return threadCount; }
+        inline auto getScheduler() noexcept { return pool.get_scheduler(); }
+
+    private:
+        CommandPoolManager* p_commandPoolManager = nullptr;
+        uint32_t threadCount = 1;
+        uint32_t chunksPerThread = 1;
+        exec::static_thread_pool pool;
+    };
+
+}
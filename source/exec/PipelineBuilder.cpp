@@ -0,0 +1,124 @@
+#include "PipelineBuilder.hpp"
+
+namespace vke{
+
+    PipelineBuilder::PipelineBuilder(const vk::raii::Device& device, const CreateInfo& createInfo)
+        : p_device{&device}, p_pipelineCache{createInfo.pipelineCache}, pool{createInfo.threadCount()} {}
+
+    PipelineBuilder::PipelineBuilder(const Device& device, const CreateInfo& createInfo)
+        : PipelineBuilder{static_cast<const vk::raii::Device&>(device), createInfo} {}
+
+    PipelineBuilder::~PipelineBuilder()
+    {
+        wait();
+    }
+
+    PipelineBuilder::Handle PipelineBuilder::build(const vk::GraphicsPipelineCreateInfo& createInfo)
+    {
+        return submit(std::make_unique<const PipelineState>(createInfo))->handle;
+    }
+
+    PipelineBuilder::Handle PipelineBuilder::build(const vk::ComputePipelineCreateInfo& createInfo)
+    {
+        return submit(std::make_unique<const PipelineState>(createInfo))->handle;
+    }
+
+    PipelineBuilder::Sender PipelineBuilder::buildSender(const vk::GraphicsPipelineCreateInfo& createInfo)
+    {
+        return Sender{ this, submit(std::make_unique<const PipelineState>(createInfo)) };
+    }
+
+    PipelineBuilder::Sender PipelineBuilder::buildSender(const vk::ComputePipelineCreateInfo& createInfo)
+    {
+        return Sender{ this, submit(std::make_unique<const PipelineState>(createInfo)) };
+    }
+
+    void PipelineBuilder::wait() const
+    {
+        std::vector<Handle> handles{};
+        {
+            std::lock_guard lock{mutex};
+            handles = std::ranges::to<std::vector<Handle>>(entries 
+                | std::ranges::views::transform([](const auto& pair) -> Handle { return pair.second->handle; }));
+        }
+
+        for(const Handle& handle : handles)
+        {
+            handle.wait();
+        }
+    }
+
+    size_t PipelineBuilder::size() const
+    {
+        std::lock_guard lock{mutex};
+        return entries.size();
+    }
+
+    PipelineBuilder::Entry* PipelineBuilder::submit(std::unique_ptr<const PipelineState> state)
+    {
+        Entry* entry = nullptr;
+        {
+            std::lock_guard lock{mutex};
+
+            auto [first, last] = entries.equal_range(state->getHash());
+            for(auto it = first; it != last; ++it)
+            {
+                if(*it->second->state == *state)
+                    return it->second.get();
+            }
+
+            auto it = entries.emplace(state->getHash(), std::make_unique<Entry>());
+            entry = it->second.get();
+            entry->state = std::move(state);
+            entry->handle = entry->promise.get_future().share();
+        }
+
+        stdexec::start_detached(stdexec::schedule(pool.get_scheduler()) 
+            | stdexec::then([this, entry]
+            {
+                std::exception_ptr exception{};
+                try
+                {
+                    const vk::raii::PipelineCache* pipelineCache = p_pipelineCache ? &p_pipelineCache->getThreadCache() : nullptr;
+                    entry->pipeline = entry->state->create(*p_device, pipelineCache);
+                }
+                catch(...)
+                {
+                    exception = std::current_exception();
+                }
+
+                std::vector<Operation*> waiters{};
+                {
+                    std::lock_guard lock{mutex};
+                    entry->exception = exception;
+                    entry->done = true;
+                    waiters.swap(entry->waiters);
+                }
+
+                for(Operation* operation : waiters)
+                {
+                    operation->complete(operation, *entry->pipeline, exception);
+                }
+
+                if(exception)
+                    entry->promise.set_exception(exception);
+                else
+                    entry->promise.set_value(*entry->pipeline);
+            }));
+
+        return entry;
+    }
+
+    void PipelineBuilder::enqueue(Entry* entry, Operation* operation)
+    {
+        {
+            std::lock_guard lock{mutex};
+            if(!entry->done)
+            {
+                entry->waiters.push_back(operation);
+                return;
+            }
+        }
+        operation->complete(operation, *entry->pipeline, entry->exception);
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <base/Pipeline.hpp>
+
+#include <stdexec/execution.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#include <exception>
+#include <future>
+
+namespace vke{
+
+    class PipelineBuilder
+    {
+    public:
+        struct CreateInfo
+        {
+            Getter<uint32_t> threadCount{ std::max(std::thread::hardware_concurrency(), 1u) };
+            PipelineCache* pipelineCache = nullptr;
+        };
+
+        using Handle = std::shared_future<vk::Pipeline>;
+
+        struct Operation
+        {
+            void (*complete)(Operation* self, vk::Pipeline pipeline, std::exception_ptr exception) noexcept = nullptr;
+        };
+
+        class Sender;
+
+        PipelineBuilder(const vk::raii::Device& device, const CreateInfo& createInfo);
+        PipelineBuilder(const Device& device, const CreateInfo& createInfo);
+        ~PipelineBuilder();
+
+        PipelineBuilder(const PipelineBuilder&) = delete;
+        PipelineBuilder& operator=(const PipelineBuilder&) = delete;
+
+        Handle build(const vk::GraphicsPipelineCreateInfo& createInfo);
+        Handle build(const vk::ComputePipelineCreateInfo& createInfo);
+        // Same deduplicated build, completing with set_value(vk::Pipeline) on the builder's thread instead of a future.
+        Sender buildSender(const vk::GraphicsPipelineCreateInfo& createInfo);
+        Sender buildSender(const vk::ComputePipelineCreateInfo& createInfo);
+
+        void wait() const;
+        size_t size() const;
+
+        inline auto getScheduler() noexcept { return pool.get_scheduler(); }
+
+    private:
+        struct Entry
+        {
+            std::unique_ptr<const PipelineState> state;
+            vk::raii::Pipeline pipeline{ nullptr };
+            std::promise<vk::Pipeline> promise;
+            Handle handle;
+            std::exception_ptr exception;
+            std::vector<Operation*> waiters;
+            bool done = false;
+        };
+
+        const vk::raii::Device* p_device = nullptr;
+        PipelineCache* p_pipelineCache = nullptr;
+        mutable std::mutex mutex;
+        std::unordered_multimap<uint64_t, std::unique_ptr<Entry>> entries;
+        exec::static_thread_pool pool;
+
+        Entry* submit(std::unique_ptr<const PipelineState> state);
+        void enqueue(Entry* entry, Operation* operation);
+    };
+
+    class PipelineBuilder::Sender
+    {
+    public:
+        using sender_concept = stdexec::sender_t;
+        using completion_signatures = stdexec::completion_signatures<
+            stdexec::set_value_t(vk::Pipeline), stdexec::set_error_t(std::exception_ptr)>;
+
+        template<class Receiver>
+        struct OperationState : PipelineBuilder::Operation
+        {
+            using operation_state_concept = stdexec::operation_state_t;
+
+            OperationState(PipelineBuilder* builder_, Entry* entry_, Receiver receiver_)
+                : PipelineBuilder::Operation{ 
+                    [](PipelineBuilder::Operation* self, vk::Pipeline pipeline, std::exception_ptr exception) noexcept
+                    {
+                        auto* operation = static_cast<OperationState*>(self);
+                        if(exception)
+                            stdexec::set_error(std::move(operation->receiver), std::move(exception));
+                        else
+                            stdexec::set_value(std::move(operation->receiver), pipeline);
+                    } },
+                builder{builder_}, entry{entry_}, receiver{std::move(receiver_)} {}
+
+            OperationState(const OperationState&) = delete;
+            OperationState& operator=(const OperationState&) = delete;
+
+            inline void start() & noexcept { builder->enqueue(entry, this); }
+
+            PipelineBuilder* builder;
+            Entry* entry;
+            Receiver receiver;
+        };
+
+        Sender(PipelineBuilder* builder, Entry* entry) noexcept : p_builder{builder}, p_entry{entry} {}
+
+        template<stdexec::receiver Receiver>
+        inline OperationState<Receiver> connect(Receiver receiver) const { return { p_builder, p_entry, std::move(receiver) }; }
+
+    private:
+        PipelineBuilder* p_builder = nullptr;
+        Entry* p_entry = nullptr;
+    };
+
+}
@@ -0,0 +1,235 @@
+#include "Scheduler.hpp"
+
+#include <base/Instrumentation.hpp>
+
+namespace vke{
+
+    namespace{
+        thread_local QueueContext* current_context = nullptr;
+        thread_local const vk::raii::CommandBuffer* current_command_buffer = nullptr;
+    }
+
+    QueueContext::QueueContext(const vk::raii::Device& device, const DeviceQueue& queue)
+        : p_device{&device}, p_queue{&queue}, semaphore{device}
+    {
+        commandPool = vk::raii::CommandPool{device, vk::CommandPoolCreateInfo{vk::CommandPoolCreateFlagBits::eResetCommandBuffer, queue.getQueueFamilyIndex()}};
+
+        recordingThread = std::jthread{[this]{ record(); }};
+        completionThread = std::jthread{[this]{ complete(); }};
+    }
+
+    QueueContext::QueueContext(const Device& device, const DeviceQueue& queue)
+        : QueueContext{static_cast<const vk::raii::Device&>(device), queue} {}
+
+    QueueContext::~QueueContext()
+    {
+        {
+            std::lock_guard lock{mutex};
+            stopping = true;
+        }
+        recordingCondition.notify_all();
+        recordingThread.join();
+
+        {
+            std::lock_guard lock{mutex};
+            recordingFinished = true;
+        }
+        completionCondition.notify_all();
+        completionThread.join();
+    }
+
+    void QueueContext::enqueueRecording(Operation* operation)
+    {
+        {
+            std::lock_guard lock{mutex};
+            if(!stopping || current_context == this)
+            {
+                pendingRecording.push_back(operation);
+                recordingCondition.notify_one();
+                return;
+            }
+        }
+        operation->stop(operation);
+    }
+
+    void QueueContext::enqueueCompletion(Operation* operation)
+    {
+        if(current_context == this)
+        {
+            batchCompletions.push_back(operation);
+            return;
+        }
+
+        uint64_t value = 0;
+        {
+            std::lock_guard lock{mutex};
+            if(!inFlight.empty())
+            {
+                inFlight.back().completions.push_back(operation);
+                return;
+            }
+            value = submittedValue;
+        }
+        operation->complete(operation, value);
+    }
+
+    const vk::raii::CommandBuffer& QueueContext::getCommandBuffer()
+    {
+        if(!current_command_buffer)
+            throw std::runtime_error("No command buffer is being recorded on this thread");
+        return *current_command_buffer;
+    }
+
+    uint64_t QueueContext::getSubmittedValue() const
+    {
+        std::lock_guard lock{mutex};
+        return submittedValue;
+    }
+
+    vk::raii::CommandBuffer QueueContext::acquireCommandBuffer()
+    {
+        {
+            std::lock_guard lock{mutex};
+            if(!freeCommandBuffers.empty())
+            {
+                vk::raii::CommandBuffer commandBuffer = std::move(freeCommandBuffers.back());
+                freeCommandBuffers.pop_back();
+                return commandBuffer;
+            }
+        }
+        return std::move(vk::raii::CommandBuffers{*p_device, vk::CommandBufferAllocateInfo{commandPool, vk::CommandBufferLevel::ePrimary, 1}}.front());
+    }
+
+    void QueueContext::record()
+    {
+        while(true)
+        {
+            std::vector<Operation*> operations{};
+            {
+                std::unique_lock lock{mutex};
+                recordingCondition.wait(lock, [this]{ return stopping || !pendingRecording.empty(); });
+                if(pendingRecording.empty())
+                    return;
+                operations.swap(pendingRecording);
+            }
+
+            vk::raii::CommandBuffer commandBuffer{ nullptr };
+            try
+            {
+                commandBuffer = acquireCommandBuffer();
+                commandBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+            }
+            catch(...)
+            {
+                fail(operations, std::current_exception());
+                continue;
+            }
+
+            current_context = this;
+            current_command_buffer = &commandBuffer;
+            while(!operations.empty())
+            {
+                for(Operation* operation : operations)
+                {
+                    operation->complete(operation, 0);
+                }
+                operations.clear();
+
+                std::lock_guard lock{mutex};
+                operations.swap(pendingRecording);
+            }
+            current_command_buffer = nullptr;
+            current_context = nullptr;
+
+            uint64_t value = 0;
+            {
+                std::lock_guard lock{mutex};
+                value = submittedValue + 1;
+            }
+
+            try
+            {
+                commandBuffer.end();
+
+                vk::Semaphore signalSemaphore = semaphore;
+                vk::TimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+                timelineSubmitInfo.setSignalSemaphoreValues(value);
+
+                vk::CommandBuffer submitCommandBuffer = *commandBuffer;
+                vk::SubmitInfo submitInfo{};
+                submitInfo.setCommandBuffers(submitCommandBuffer)
+                    .setSignalSemaphores(signalSemaphore)
+                    .setPNext(&timelineSubmitInfo);
+
+                VKE_ZONE("QueueContext::submit");
+                p_queue->submit(submitInfo);
+            }
+            catch(...)
+            {
+                fail(std::exchange(batchCompletions, {}), std::current_exception());
+                continue;
+            }
+
+            {
+                std::lock_guard lock{mutex};
+                submittedValue = value;
+                inFlight.push_back(Batch{value, std::move(commandBuffer), std::move(batchCompletions)});
+            }
+            batchCompletions.clear();
+            completionCondition.notify_one();
+        }
+    }
+
+    void QueueContext::complete()
+    {
+        while(true)
+        {
+            uint64_t value = 0;
+            {
+                std::unique_lock lock{mutex};
+                completionCondition.wait(lock, [this]{ return recordingFinished || !inFlight.empty(); });
+                if(inFlight.empty())
+                    return;
+                value = inFlight.front().value;
+            }
+
+            std::exception_ptr exception{};
+            try
+            {
+                semaphore.wait(value);
+            }
+            catch(...)
+            {
+                exception = std::current_exception();
+            }
+
+            std::vector<Operation*> completions{};
+            {
+                std::lock_guard lock{mutex};
+                completions = std::move(inFlight.front().completions);
+                if(!exception)
+                    freeCommandBuffers.push_back(std::move(inFlight.front().commandBuffer));
+                inFlight.pop_front();
+            }
+
+            if(exception)
+            {
+                fail(std::move(completions), exception);
+                continue;
+            }
+
+            for(Operation* operation : completions)
+            {
+                operation->complete(operation, value);
+            }
+        }
+    }
+
+    void QueueContext::fail(std::vector<Operation*> operations, std::exception_ptr exception) noexcept
+    {
+        for(Operation* operation : operations)
+        {
+            operation->error(operation, exception);
+        }
+    }
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <base/Base.hpp>
+#include <base/Synchronization.hpp>
+
+#include <stdexec/execution.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <thread>
+
+namespace vke{
+
+    class QueueScheduler;
+
+    class QueueContext
+    {
+    public:
+        struct Operation
+        {
+            void (*complete)(Operation* self, uint64_t value) noexcept = nullptr;
+            void (*stop)(Operation* self) noexcept = nullptr;
+            void (*error)(Operation* self, std::exception_ptr exception) noexcept = nullptr;
+        };
+
+        QueueContext(const vk::raii::Device& device, const DeviceQueue& queue);
+        QueueContext(const Device& device, const DeviceQueue& queue);
+        ~QueueContext();
+
+        QueueContext(const QueueContext&) = delete;
+        QueueContext& operator=(const QueueContext&) = delete;
+
+        QueueScheduler getScheduler() noexcept;
+
+        void enqueueRecording(Operation* operation);
+        void enqueueCompletion(Operation* operation);
+
+        static const vk::raii::CommandBuffer& getCommandBuffer();
+
+        inline vk::Semaphore getSemaphore() const noexcept { return semaphore; }
+        inline const DeviceQueue& getQueue() const noexcept { return *p_queue; }
+        uint64_t getSubmittedValue() const;
+
+    private:
+        struct Batch
+        {
+            uint64_t value = 0;
+            vk::raii::CommandBuffer commandBuffer{ nullptr };
+            std::vector<Operation*> completions;
+        };
+
+        const vk::raii::Device* p_device = nullptr;
+        const DeviceQueue* p_queue = nullptr;
+        vk::raii::CommandPool commandPool{ nullptr };
+        TimelineSemaphore semaphore;
+
+        mutable std::mutex mutex;
+        std::condition_variable recordingCondition;
+        std::condition_variable completionCondition;
+        std::vector<Operation*> pendingRecording;
+        std::vector<Operation*> batchCompletions;
+        std::deque<Batch> inFlight;
+        std::vector<vk::raii::CommandBuffer> freeCommandBuffers;
+        uint64_t submittedValue = 0;
+        bool stopping = false;
+        bool recordingFinished = false;
+
+        std::jthread recordingThread;
+        std::jthread completionThread;
+
+        vk::raii::CommandBuffer acquireCommandBuffer();
+        void record();
+        void complete();
+        static void fail(std::vector<Operation*> operations, std::exception_ptr exception) noexcept;
+    };
+
+    class QueueScheduler
+    {
+    public:
+        explicit QueueScheduler(QueueContext& context) noexcept : p_context{&context} {}
+
+        template<class Receiver>
+        struct ScheduleOperation : QueueContext::Operation
+        {
+            using operation_state_concept = stdexec::operation_state_t;
+
+            ScheduleOperation(QueueContext* context_, Receiver receiver_)
+                : QueueContext::Operation{ 
+                    [](QueueContext::Operation* self, uint64_t) noexcept { stdexec::set_value(std::move(static_cast<ScheduleOperation*>(self)->receiver)); },
+                    [](QueueContext::Operation* self) noexcept { stdexec::set_stopped(std::move(static_cast<ScheduleOperation*>(self)->receiver)); },
+                    [](QueueContext::Operation* self, std::exception_ptr exception) noexcept
+                        { stdexec::set_error(std::move(static_cast<ScheduleOperation*>(self)->receiver), std::move(exception)); } },
+                context{context_}, receiver{std::move(receiver_)} {}
+
+            ScheduleOperation(const ScheduleOperation&) = delete;
+            ScheduleOperation& operator=(const ScheduleOperation&) = delete;
+
+            inline void start() & noexcept 
+            {
+                try
+                {
+                    context->enqueueRecording(this);
+                }
+                catch(...)
+                {
+                    stdexec::set_error(std::move(receiver), std::current_exception());
+                }
+            }
+
+            QueueContext* context;
+            Receiver receiver;
+        };
+
+        struct ScheduleSender
+        {
+            using sender_concept = stdexec::sender_t;
+            using completion_signatures = stdexec::completion_signatures<
+                stdexec::set_value_t(), stdexec::set_error_t(std::exception_ptr), stdexec::set_stopped_t()>;
+
+            struct Env
+            {
+                template<class CPO>
+                inline QueueScheduler query(stdexec::get_completion_scheduler_t<CPO>) const noexcept { return QueueScheduler{*context}; }
+
+                QueueContext* context;
+            };
+
+            template<stdexec::receiver Receiver>
+            inline ScheduleOperation<Receiver> connect(Receiver receiver) const { return { context, std::move(receiver) }; }
+
+            inline Env get_env() const noexcept { return { context }; }
+
+            QueueContext* context;
+        };
+
+        template<class Receiver>
+        struct CompletionOperation : QueueContext::Operation
+        {
+            using operation_state_concept = stdexec::operation_state_t;
+
+            CompletionOperation(QueueContext* context_, Receiver receiver_)
+                : QueueContext::Operation{ 
+                    [](QueueContext::Operation* self, uint64_t value) noexcept { stdexec::set_value(std::move(static_cast<CompletionOperation*>(self)->receiver), value); },
+                    [](QueueContext::Operation* self) noexcept { stdexec::set_stopped(std::move(static_cast<CompletionOperation*>(self)->receiver)); },
+                    [](QueueContext::Operation* self, std::exception_ptr exception) noexcept
+                        { stdexec::set_error(std::move(static_cast<CompletionOperation*>(self)->receiver), std::move(exception)); } },
+                context{context_}, receiver{std::move(receiver_)} {}
+
+            CompletionOperation(const CompletionOperation&) = delete;
+            CompletionOperation& operator=(const CompletionOperation&) = delete;
+
+            inline void start() & noexcept 
+            {
+                try
+                {
+                    context->enqueueCompletion(this);
+                }
+                catch(...)
+                {
+                    stdexec::set_error(std::move(receiver), std::current_exception());
+                }
+            }
+
+            QueueContext* context;
+            Receiver receiver;
+        };
+
+        struct CompletionSender
+        {
+            using sender_concept = stdexec::sender_t;
+            using completion_signatures = stdexec::completion_signatures<
+                stdexec::set_value_t(uint64_t), stdexec::set_error_t(std::exception_ptr), stdexec::set_stopped_t()>;
+
+            template<stdexec::receiver Receiver>
+            inline CompletionOperation<Receiver> connect(Receiver receiver) const { return { context, std::move(receiver) }; }
+
+            QueueContext* context;
+        };
+
+        inline ScheduleSender schedule() const noexcept { return { p_context }; }
+        inline CompletionSender completion() const noexcept { return { p_context }; }
+
+        inline static const vk::raii::CommandBuffer& getCommandBuffer() { return QueueContext::getCommandBuffer(); }
+
+        inline bool operator==(const QueueScheduler& other) const noexcept { return p_context == other.p_context; }
+
+    private:
+        QueueContext* p_context = nullptr;
+    };
+
+    inline QueueScheduler QueueContext::getScheduler() noexcept
+    {
+        return QueueScheduler{*this};
+    }
+
+}
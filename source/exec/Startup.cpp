@@ -0,0 +1,136 @@
+#include "Startup.hpp"
+
+#include <format>
+
+namespace vke{
+
+    StartupGraph::StartupGraph(const CreateInfo& createInfo)
+        : pool{createInfo.threadCount()}
+    {
+    }
+
+    StartupGraph::~StartupGraph()
+    {
+        if(running.load(std::memory_order_acquire))
+            completed.wait(false, std::memory_order_acquire);
+    }
+
+    StartupGraph::TaskId StartupGraph::addTask(std::string name, const std::vector<TaskId>& dependencies)
+    {
+        if(running.load(std::memory_order_relaxed))
+            throw std::runtime_error{"vke::StartupGraph::add, graph is already running"};
+
+        TaskId id = static_cast<TaskId>(tasks.size());
+        for(TaskId dependency : dependencies)
+            if(dependency >= id)
+                throw std::runtime_error{std::format("vke::StartupGraph::add, task \"{}\" depends on unknown task {}", name, dependency)};
+
+        Task& task = tasks.emplace_back();
+        task.name = std::move(name);
+        task.dependencyCount = static_cast<uint32_t>(dependencies.size());
+        for(TaskId dependency : dependencies)
+            tasks[dependency].dependents.push_back(id);
+        return id;
+    }
+
+    void StartupGraph::start(Operation* operation) noexcept
+    {
+        if(running.exchange(true, std::memory_order_acq_rel))
+        {
+            operation->complete(operation, std::make_exception_ptr(std::runtime_error{"vke::StartupGraph::run, graph was already started"}));
+            return;
+        }
+
+        p_operation = operation;
+        startTime = std::chrono::steady_clock::now();
+        if(tasks.empty())
+        {
+            finishTime = startTime;
+            completed.store(true, std::memory_order_release);
+            operation->complete(operation, nullptr);
+            return;
+        }
+
+        for(Task& task : tasks)
+            task.remaining.store(task.dependencyCount, std::memory_order_relaxed);
+
+        std::vector<TaskId> roots = tasks | std::views::enumerate
+            | std::views::filter([](const auto& pair){ return std::get<1>(pair).dependencyCount == 0; })
+            | std::views::transform([](const auto& pair){ return static_cast<TaskId>(std::get<0>(pair)); })
+            | std::ranges::to<std::vector>();
+        for(TaskId id : roots)
+            tasks[id].body->start();
+    }
+
+    void StartupGraph::finish(TaskId id, std::exception_ptr taskException) noexcept
+    {
+        Task& task = tasks[id];
+        task.end = std::chrono::steady_clock::now();
+
+        bool failed = false;
+        {
+            std::lock_guard lock{exceptionMutex};
+            if(taskException && !exception)
+                exception = std::move(taskException);
+            failed = static_cast<bool>(exception);
+        }
+
+        for(TaskId dependent : task.dependents)
+        {
+            if(tasks[dependent].remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                continue;
+
+            if(failed)
+            {
+                tasks[dependent].skipped = true;
+                tasks[dependent].begin = task.end;
+                finish(dependent, nullptr);
+            }
+            else
+                tasks[dependent].body->start();
+        }
+
+        if(finishedCount.fetch_add(1, std::memory_order_acq_rel) + 1 != tasks.size())
+            return;
+
+        finishTime = std::chrono::steady_clock::now();
+        std::exception_ptr result;
+        {
+            std::lock_guard lock{exceptionMutex};
+            result = exception;
+        }
+        Operation* operation = p_operation;
+        completed.store(true, std::memory_order_release);
+        completed.notify_all();
+        operation->complete(operation, std::move(result));
+    }
+
+    void StartupGraph::wait()
+    {
+        stdexec::sync_wait(run());
+    }
+
+    std::vector<StartupGraph::TaskTiming> StartupGraph::getTimings() const
+    {
+        return tasks | std::views::transform([this](const Task& task)
+            {
+                return TaskTiming{ task.name, task.begin - startTime, task.end - startTime, task.skipped };
+            }) | std::ranges::to<std::vector>();
+    }
+
+    std::vector<TraceEvent> StartupGraph::getTraceEvents(uint32_t processId) const
+    {
+        return tasks | std::views::enumerate | std::views::transform([this, processId](const auto& pair)
+            {
+                const auto& [index, task] = pair;
+                TraceEvent event{};
+                event.name = task.name;
+                event.processId = processId;
+                event.threadId = static_cast<uint32_t>(index);
+                event.begin = std::chrono::duration_cast<std::chrono::nanoseconds>(task.begin.time_since_epoch()).count();
+                event.end = std::chrono::duration_cast<std::chrono::nanoseconds>(task.end.time_since_epoch()).count();
+                return event;
+            }) | std::ranges::to<std::vector>();
+    }
+
+}
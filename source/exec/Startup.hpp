@@ -0,0 +1,202 @@
+#pragma once
+
+#include <base/Common.hpp>
+#include <base/Trace.hpp>
+
+#include <stdexec/execution.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace vke{
+
+    class StartupGraph
+    {
+    public:
+        using TaskId = uint32_t;
+
+        struct CreateInfo
+        {
+            Getter<uint32_t> threadCount{ std::max(std::thread::hardware_concurrency(), 1u) };
+        };
+
+        struct TaskTiming
+        {
+            std::string name;
+            std::chrono::nanoseconds begin{0};
+            std::chrono::nanoseconds end{0};
+            bool skipped = false;
+        };
+
+        struct Operation
+        {
+            void (*complete)(Operation* self, std::exception_ptr exception) noexcept = nullptr;
+        };
+
+        explicit StartupGraph(const CreateInfo& createInfo);
+        ~StartupGraph();
+
+        StartupGraph(const StartupGraph&) = delete;
+        StartupGraph& operator=(const StartupGraph&) = delete;
+
+        template<stdexec::sender Sender>
+        TaskId add(std::string name, const std::vector<TaskId>& dependencies, Sender&& sender)
+        {
+            TaskId id = addTask(std::move(name), dependencies);
+            tasks[id].body = std::make_unique<SenderTask<std::remove_cvref_t<Sender>>>(std::forward<Sender>(sender), this, id);
+            return id;
+        }
+
+        template<class F>
+            requires (!stdexec::sender<F>) && std::invocable<F&>
+        TaskId add(std::string name, const std::vector<TaskId>& dependencies, F&& function)
+        {
+            TaskId id = static_cast<TaskId>(tasks.size());
+            return add(std::move(name), dependencies, stdexec::schedule(pool.get_scheduler())
+                | stdexec::then([this, id, function = std::forward<F>(function)]() mutable
+                {
+                    tasks[id].begin = std::chrono::steady_clock::now();
+                    std::invoke(function);
+                }));
+        }
+
+        template<class Receiver>
+        struct RunOperation : Operation
+        {
+            using operation_state_concept = stdexec::operation_state_t;
+
+            RunOperation(StartupGraph* graph_, Receiver receiver_)
+                : Operation{ [](Operation* self, std::exception_ptr exception) noexcept 
+                    {
+                        auto* operation = static_cast<RunOperation*>(self);
+                        if(exception)
+                            stdexec::set_error(std::move(operation->receiver), std::move(exception));
+                        else
+                            stdexec::set_value(std::move(operation->receiver));
+                    } },
+                graph{graph_}, receiver{std::move(receiver_)} {}
+
+            RunOperation(const RunOperation&) = delete;
+            RunOperation& operator=(const RunOperation&) = delete;
+
+            inline void start() & noexcept { graph->start(this); }
+
+            StartupGraph* graph;
+            Receiver receiver;
+        };
+
+        struct RunSender
+        {
+            using sender_concept = stdexec::sender_t;
+            using completion_signatures = stdexec::completion_signatures<
+                stdexec::set_value_t(), stdexec::set_error_t(std::exception_ptr)>;
+
+            template<stdexec::receiver Receiver>
+            inline RunOperation<Receiver> connect(Receiver receiver) const { return { graph, std::move(receiver) }; }
+
+            StartupGraph* graph;
+        };
+
+        inline RunSender run() noexcept { return { this }; }
+        void wait();
+
+        std::vector<TaskTiming> getTimings() const;
+        std::vector<TraceEvent> getTraceEvents(uint32_t processId = 0) const;
+        inline std::chrono::nanoseconds getElapsed() const noexcept { return finishTime - startTime; }
+        inline size_t size() const noexcept { return tasks.size(); }
+        inline auto getScheduler() noexcept { return pool.get_scheduler(); }
+
+    private:
+        struct TaskBase
+        {
+            virtual ~TaskBase() = default;
+            virtual void start() noexcept = 0;
+        };
+
+        struct TaskReceiver
+        {
+            using receiver_concept = stdexec::receiver_t;
+
+            template<class ... Values>
+            inline void set_value(Values&&...) && noexcept { graph->finish(id, nullptr); }
+            template<class Error>
+            inline void set_error(Error&& error) && noexcept 
+            {
+                if constexpr (std::same_as<std::remove_cvref_t<Error>, std::exception_ptr>)
+                    graph->finish(id, std::forward<Error>(error));
+                else
+                    graph->finish(id, std::make_exception_ptr(std::forward<Error>(error)));
+            }
+            inline void set_stopped() && noexcept 
+            { 
+                graph->finish(id, std::make_exception_ptr(std::runtime_error{"vke::StartupGraph task was stopped"})); 
+            }
+            inline stdexec::env<> get_env() const noexcept { return {}; }
+
+            StartupGraph* graph;
+            TaskId id;
+        };
+
+        template<class Sender>
+        struct SenderTask : TaskBase
+        {
+            using OperationState = stdexec::connect_result_t<Sender, TaskReceiver>;
+
+            SenderTask(Sender sender_, StartupGraph* graph_, TaskId id_) : sender{std::move(sender_)}, graph{graph_}, id{id_} {}
+
+            void start() noexcept override
+            {
+                graph->tasks[id].begin = std::chrono::steady_clock::now();
+                try
+                {
+                    operation.reset(new OperationState(stdexec::connect(std::move(sender), TaskReceiver{graph, id})));
+                    stdexec::start(*operation);
+                }
+                catch(...)
+                {
+                    graph->finish(id, std::current_exception());
+                }
+            }
+
+            Sender sender;
+            StartupGraph* graph;
+            TaskId id;
+            std::unique_ptr<OperationState> operation;
+        };
+
+        struct Task
+        {
+            std::string name;
+            std::vector<TaskId> dependents;
+            uint32_t dependencyCount = 0;
+            std::atomic<uint32_t> remaining{0};
+            std::unique_ptr<TaskBase> body;
+            std::chrono::steady_clock::time_point begin{};
+            std::chrono::steady_clock::time_point end{};
+            bool skipped = false;
+        };
+
+        std::deque<Task> tasks;
+        Operation* p_operation = nullptr;
+        std::atomic<size_t> finishedCount{0};
+        std::atomic<bool> running{false};
+        std::atomic<bool> completed{false};
+        std::mutex exceptionMutex;
+        std::exception_ptr exception{};
+        std::chrono::steady_clock::time_point startTime{};
+        std::chrono::steady_clock::time_point finishTime{};
+        // Declared last so its threads are joined before the task state they touch is destroyed.
+        exec::static_thread_pool pool;
+
+        TaskId addTask(std::string name, const std::vector<TaskId>& dependencies);
+        void start(Operation* operation) noexcept;
+        void finish(TaskId id, std::exception_ptr taskException) noexcept;
+    };
+
+}
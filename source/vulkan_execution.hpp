@@ -4,4 +4,15 @@
 #include "base/Window.hpp"
 #include "base/Memory.hpp"
 #include "base/Resources.hpp"
-#include "base/Synchronization.hpp"
\ No newline at end of file
+#include "base/Synchronization.hpp"
+#include "base/Pipeline.hpp"
+#include "base/Shader.hpp"
+#include "base/Task.hpp"
+#include "base/Submission.hpp"
+#include "base/Command.hpp"
+#include "base/Queue.hpp"
+#include "base/Profiler.hpp"
+#include "base/Instrumentation.hpp"
+#include "base/Statistics.hpp"
+#include "base/Query.hpp"
+#include "base/Debug.hpp"
\ No newline at end of file
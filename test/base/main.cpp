@@ -3,6 +3,8 @@
 
 #include <extension/glfw.hpp>
 
+#include "test_base_shaders.hpp"
+
 #include <ranges>
 #include <iostream>
 
@@ -29,6 +31,53 @@ struct UniformBufferObject {
 class HelloTriangleApplication
 {
 public:
+    ~HelloTriangleApplication()
+    {
+        static_cast<const vk::raii::Device&>(device).waitIdle();
+        deletionQueue.flush();
+        vke::setDefaultDeletionQueue(previousDeletionQueue);
+    }
+
+    void testDeferredDeletion()
+    {
+        vk::raii::CommandPool commandPool{device, vk::CommandPoolCreateInfo{ vk::CommandPoolCreateFlagBits::eTransient, graphicsQueue.getQueueFamilyIndex() }};
+        vk::raii::CommandBuffer commandBuffer = std::move(vk::raii::CommandBuffers{device, 
+            vk::CommandBufferAllocateInfo{ *commandPool, vk::CommandBufferLevel::ePrimary, 1 } }.front());
+
+        deletionQueue.flush();
+        {
+            vke::Buffer<uint32_t> scratchBuffer{device, vke::BufferWrapper::CreateInfo{
+                .size = 1 << 20,
+                .usage = vk::BufferUsageFlags{vk::BufferUsageFlagBits::eTransferDst},
+                .queueFamilyIndices{ std::vector<uint32_t>{graphicsQueue.getQueueFamilyIndex()} }
+            }, deviceLocalMemory};
+
+            commandBuffer.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+            commandBuffer.fillBuffer(static_cast<vk::Buffer>(scratchBuffer), 0, vk::WholeSize, 0);
+            commandBuffer.end();
+
+            vk::CommandBuffer submitCommandBuffer = *commandBuffer;
+            graphicsQueue.submit(vk::SubmitInfo{}.setCommandBuffers(submitCommandBuffer));
+        }
+
+        if(deletionQueue.size() == 0)
+            throw std::runtime_error{"vke::DeletionQueue destroyed a buffer that was still in flight"};
+
+        graphicsQueue.wait(graphicsQueue.getSubmittedValue());
+        deletionQueue.collect();
+
+        if(deletionQueue.size() != 0)
+            throw std::runtime_error{"vke::DeletionQueue kept a buffer after its submission completed"};
+    }
+
+    void testEmbeddedShaders()
+    {
+        vke::ShaderModule fillShader{device, shaders::fill_comp};
+        const vke::ShaderModule::Reflection& reflection = fillShader.getReflection();
+
+        if(reflection.stage != vk::ShaderStageFlagBits::eCompute || reflection.descriptorSets.size() != 1 || reflection.pushConstantRanges.size() != 1)
+            throw std::runtime_error{"vke::ShaderModule reflected the embedded fill shader incorrectly"};
+    }
 
 private:
     vke::GLFWInstance glfwInstance{};
@@ -45,13 +94,11 @@ private:
         .width = 800, .height = 600, .title = "test_base", 
         .triggerSetFramebufferSize = [this](uint32_t w, uint32_t h){ triggerSetFramebufferSize({w, h}); } } };
     vke::Device device = vke::Device{instance, vke::Device::CreateInfo{ 
-        .physicalDevicSelecter{[this](const vk::raii::PhysicalDevice& p) -> uint32_t
+        .physicalDevicSelecter{[this](const vke::PhysicalDeviceCapabilities& p) -> uint32_t
         {
-            auto properties = p.getProperties();
-
             uint32_t score = 0;
 
-            switch(properties.deviceType)
+            switch(p.properties.deviceType)
             {
             case vk::PhysicalDeviceType::eDiscreteGpu:
                 score += 50;
@@ -67,27 +114,24 @@ private:
             }
 
             return score;
-        }, [this](const vk::raii::PhysicalDevice& p) -> bool
+        }, [this](const vke::PhysicalDeviceCapabilities& p) -> bool
         {
-            return std::ranges::includes(p.enumerateDeviceExtensionProperties() | std::views::transform([](vk::ExtensionProperties eps){ return eps.extensionName; }), 
-                glfwInstance.getDeviceExtensions(), std::strcmp);
+            return std::ranges::all_of(glfwInstance.getDeviceExtensions(), [&](const char* extensionName){ return p.isExtensionSupported(extensionName); });
         } },
-        .deviceQueueInfos = [this](const vk::raii::PhysicalDevice& p)
+        .deviceQueueInfos = [this](const vke::PhysicalDeviceCapabilities& p)
         {
-            auto queueProperties = p.getQueueFamilyProperties();
-
-            std::vector<std::vector<vke::DeviceQueueInfo>> deviceQueueInfos(queueProperties.size());
+            std::vector<std::vector<vke::DeviceQueueInfo>> deviceQueueInfos(p.queueFamilies.size());
 
             uint32_t graphicsFamilies = 0, presentFamilies = 0;
 
-            for(const auto& [index, queueFamily] : queueProperties | std::views::enumerate)
+            for(const auto& [index, queueFamily] : p.queueFamilies | std::views::enumerate)
             {
                 if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics) 
                 {
                     graphicsFamilies |= ( 1 << index );
                 }
                 
-                if (p.getSurfaceSupportKHR(index, window.getSurface())) 
+                if (p->getSurfaceSupportKHR(index, window.getSurface())) 
                 {
                     presentFamilies |= ( 1 << index );
                 }
@@ -144,10 +188,22 @@ private:
     const vke::DeviceQueue& presentQueue = device.getDeviceQueue(
         [](const vke::DeviceQueueInfo& queue) { return queue.queueUsageFlags | QueueUsageFlagBits::ePresent; });
 
+    vke::PipelineCache pipelineCache{device, vke::PipelineCache::CreateInfo{
+        .path = std::filesystem::path{"test_base.pipeline_cache"}
+    }};
+
     vke::NewDeleteDeviceMemoryResource memoryResource{device};
     vke::FilterDeviceMemoryResource deviceLocalMemory{device.getPhysicalDevice(), &memoryResource, vk::MemoryPropertyFlagBits::eDeviceLocal};
     vke::MappedDeviceMemoryResource mappedMemory{device.getPhysicalDevice(), &memoryResource};
     vke::QueueTransferMemoryResource transferMemory{device, &memoryResource};
+
+    vke::DeletionQueue deletionQueue{device};
+    vke::DeletionQueue* previousDeletionQueue = [this]
+    {
+        vke::DeletionQueue* previous = vke::getDefaultDeletionQueue();
+        vke::setDefaultDeletionQueue(&deletionQueue);
+        return previous;
+    }();
     
     vke::Swapchain swapchain{device, vke::Swapchain::CreateInfo{
         .surface = window.getSurface(),
@@ -204,6 +260,7 @@ private:
 
     void triggerSetFramebufferSize(vk::Extent2D extent)
     {
+        deletionQueue.collect();
         swapchain.recreate(device);
         depthImage.recreate(device, deviceLocalMemory);
     }
@@ -212,4 +269,6 @@ private:
 int main()
 {
     HelloTriangleApplication app{};
+    app.testDeferredDeletion();
+    app.testEmbeddedShaders();
 }
\ No newline at end of file
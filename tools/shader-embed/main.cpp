@@ -0,0 +1,137 @@
+#include <vulkan_execution.hpp>
+
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace{
+    struct Shader
+    {
+        std::string name;
+        std::filesystem::path path;
+    };
+
+    struct Options
+    {
+        std::filesystem::path output;
+        std::string nameSpace = "shaders";
+        std::vector<Shader> shaders;
+
+        static Options parse(std::span<char*> arguments)
+        {
+            Options options{};
+
+            for(size_t index = 1; index < arguments.size(); index++)
+            {
+                std::string_view argument = arguments[index];
+                auto next = [&]() -> std::string_view
+                {
+                    if(index + 1 >= arguments.size())
+                        throw std::runtime_error{std::format("vke-shader-embed, Missing value for {}", argument)};
+                    return arguments[++index];
+                };
+
+                if(argument == "--output")
+                    options.output = next();
+                else if(argument == "--namespace")
+                    options.nameSpace = next();
+                else if(auto separator = argument.find('='); separator != std::string_view::npos && !argument.starts_with("--"))
+                    options.shaders.emplace_back(std::string{argument.substr(0, separator)}, std::filesystem::path{argument.substr(separator + 1)});
+                else
+                    throw std::runtime_error{std::format("vke-shader-embed, Unknown argument: {}\n"
+                        "usage: vke-shader-embed --output FILE [--namespace NAME] NAME=FILE.spv...", argument)};
+            }
+
+            if(options.output.empty())
+                throw std::runtime_error{"vke-shader-embed, Missing --output"};
+
+            return options;
+        }
+    };
+
+    void writeReflection(std::ostream& stream, const vke::ShaderModule::Reflection& reflection)
+    {
+        stream << "        return vke::ShaderModule::Reflection{\n";
+        stream << std::format("            .stage = static_cast<vk::ShaderStageFlagBits>({:#x}),\n", static_cast<uint32_t>(reflection.stage));
+        stream << std::format("            .entryPoint = \"{}\",\n", reflection.entryPoint);
+
+        stream << "            .descriptorSets = {";
+        for(const auto& descriptorSet : reflection.descriptorSets)
+        {
+            stream << std::format("\n                vke::ShaderModule::DescriptorSet{{ {}, {{", descriptorSet.set);
+            for(const auto& binding : descriptorSet.bindings)
+                stream << std::format("\n                    vk::DescriptorSetLayoutBinding{{ {}, static_cast<vk::DescriptorType>({}), {}, static_cast<vk::ShaderStageFlags>({:#x}) }},",
+                    binding.binding, static_cast<int32_t>(binding.descriptorType), binding.descriptorCount, static_cast<uint32_t>(binding.stageFlags));
+            stream << " } },";
+        }
+        stream << " },\n";
+
+        stream << "            .pushConstantRanges = {";
+        for(const auto& range : reflection.pushConstantRanges)
+            stream << std::format("\n                vk::PushConstantRange{{ static_cast<vk::ShaderStageFlags>({:#x}), {}, {} }},", 
+                static_cast<uint32_t>(range.stageFlags), range.offset, range.size);
+        stream << " },\n";
+
+        stream << "            .vertexAttributes = {";
+        for(const auto& attribute : reflection.vertexAttributes)
+            stream << std::format("\n                vk::VertexInputAttributeDescription{{ {}, {}, static_cast<vk::Format>({}), {} }},", 
+                attribute.location, attribute.binding, static_cast<int32_t>(attribute.format), attribute.offset);
+        stream << " },\n";
+
+        stream << std::format("            .vertexStride = {} }};\n", reflection.vertexStride);
+    }
+
+    void writeShader(std::ostream& stream, const Shader& shader)
+    {
+        std::vector<uint32_t> code = vke::ShaderModule::readFile(shader.path);
+        if(code.empty() || code.front() != 0x07230203u)
+            throw std::runtime_error{std::format("vke-shader-embed, {} is not a SPIR-V module", shader.path.string())};
+
+        vke::ShaderModule::Reflection reflection = vke::ShaderModule::reflect(code);
+
+        stream << std::format("    inline constexpr std::array<uint32_t, {}> {}_code{{", code.size(), shader.name);
+        for(const auto& [index, word] : code | std::views::enumerate)
+            stream << (index % 8 ? " " : "\n        ") << std::format("{:#010x}u,", word);
+        stream << "\n    };\n\n";
+
+        stream << std::format("    inline vke::ShaderModule::Reflection {}_reflection()\n    {{\n", shader.name);
+        writeReflection(stream, reflection);
+        stream << "    }\n\n";
+
+        stream << std::format("    inline constexpr vke::ShaderModule::Embedded {0}{{ {0}_code, &{0}_reflection }};\n", shader.name);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        Options options = Options::parse(std::span<char*>{argv, static_cast<size_t>(argc)});
+
+        std::ostringstream stream{};
+        stream << "#pragma once\n\n"
+            "#include <base/Shader.hpp>\n\n"
+            "#include <array>\n"
+            "#include <cstdint>\n\n";
+        stream << std::format("namespace {}{{\n", options.nameSpace);
+        for(const auto& shader : options.shaders)
+        {
+            stream << "\n";
+            writeShader(stream, shader);
+        }
+        stream << "\n}\n";
+
+        std::ofstream file{options.output, std::ios::trunc};
+        if(!file)
+            throw std::runtime_error{std::format("vke-shader-embed, Failed to open {}", options.output.string())};
+        file << stream.str();
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}